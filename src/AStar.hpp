@@ -0,0 +1,80 @@
+#ifndef A_STAR_HPP
+#define A_STAR_HPP
+
+#include "RoadGraph.hpp"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// A* sur un graphe CSR à indices denses : RoadGraph, ou MappedGeoBox qui expose la même
+// interface (num_nodes, edge_begin / edge_end, edge_target, edge_weight, chord_distance)
+// directement sur la projection du fichier.
+// File de priorité binaire (f, node) avec suppression paresseuse ; heuristique = distance
+// en corde, minorant admissible (le facteur 0.9999 absorbe les arrondis float des poids).
+// Renvoie vrai si target est atteint : workspace.g_score[target] est alors la distance et
+// parent_node / parent_edge décrivent le chemin (parent_node[start] = INVALID_INDEX).
+// expanded_nodes (optionnel) est incrémenté de chaque node développé.
+template <typename Graph>
+bool a_star_search(const Graph& graph, SearchWorkspace& workspace,
+                   uint32_t start, uint32_t target, size_t* expanded_nodes = nullptr) {
+    workspace.prepare(graph.num_nodes());
+
+    using OpenEntry = std::pair<float, uint32_t>;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+    auto h = [&](uint32_t u) {
+        return static_cast<float>(0.9999 * graph.chord_distance(u, target));
+    };
+
+    workspace.g_score[start] = 0.0f;
+    workspace.parent_node[start] = RoadGraph::INVALID_INDEX;
+    workspace.mark_seen(start);
+    open.emplace(h(start), start);
+
+    while (!open.empty()) {
+        const uint32_t actual_node = open.top().second;
+        open.pop();
+
+        if (workspace.closed(actual_node)) {
+            continue; // Déjà développé via un meilleur chemin
+        }
+        workspace.mark_closed(actual_node);
+
+        if (expanded_nodes) ++(*expanded_nodes);
+
+        if (actual_node == target) {
+            return true;
+        }
+
+        const float actual_gScore = workspace.g_score[actual_node];
+
+        for (uint32_t e = graph.edge_begin(actual_node); e < graph.edge_end(actual_node); ++e) {
+            const uint32_t neighbor = graph.edge_target(e);
+            if (workspace.closed(neighbor)) continue;
+
+            const float tentative_gScore = actual_gScore + graph.edge_weight(e);
+            if (!workspace.seen(neighbor) || tentative_gScore < workspace.g_score[neighbor]) {
+                workspace.mark_seen(neighbor);
+                workspace.g_score[neighbor] = tentative_gScore;
+                workspace.parent_node[neighbor] = actual_node;
+                workspace.parent_edge[neighbor] = e;
+                open.emplace(tentative_gScore + h(neighbor), neighbor);
+            }
+        }
+    }
+
+    return false;
+}
+
+// Arêtes du chemin trouvé par a_star_search, de start vers target
+inline std::vector<uint32_t> a_star_edge_path(const SearchWorkspace& workspace, uint32_t target) {
+    std::vector<uint32_t> edge_path;
+    for (uint32_t u = target; workspace.parent_node[u] != RoadGraph::INVALID_INDEX; u = workspace.parent_node[u]) {
+        edge_path.push_back(workspace.parent_edge[u]);
+    }
+    return {edge_path.rbegin(), edge_path.rend()};
+}
+
+#endif // A_STAR_HPP
@@ -1,4 +1,7 @@
 #include "Box.hpp"
+#include "PbfBlockIndex.hpp"
+#include "SpatialIndex.hpp"
+#include "Common/ThreadPool.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -11,6 +14,7 @@
 #include <osmium/visitor.hpp>
 #include <osmium/io/any_input.hpp>
 #include <osmium/io/error.hpp>
+#include <osmium/memory/buffer.hpp>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
@@ -36,19 +40,9 @@ double MyHandler::calculate_haversine_distance(double lat1, double lon1, double
     return ::calculate_haversine_distance(lat1, lon1, lat2, lon2);
 }
 
-osmium::object_id_type find_nearest_point(const MyData& data, double target_lat, double target_lon) {
-    double min_distance = std::numeric_limits<double>::max();
-    osmium::object_id_type nearest_id = 0;
-    
-    for (const auto& [node_id, point] : data.nodes) {
-        double distance = calculate_haversine_distance(point.lat, point.lon, target_lat, target_lon);
-        if (distance < min_distance) {
-            min_distance = distance;
-            nearest_id = node_id;
-        }
-    }
-    
-    return nearest_id;
+// Node le plus proche via l'index spatial (construit une fois par lot de requêtes)
+osmium::object_id_type find_nearest_point(const SpatialIndex& index, double target_lat, double target_lon) {
+    return index.nearest(target_lat, target_lon);
 }
 
 bool is_valid_way_type(const osmium::Way& way) {
@@ -85,18 +79,27 @@ void MyHandler::node(const osmium::Node& node) {
     const osmium::Location node_loc = node.location();
     if (!node_loc.valid()) return;
     
-    if (m_use_bbox_filter) {
-        m_node_locations[node.id()] = node_loc;
-        if (!Map_bbox.contains(node_loc)) {
-            return;
-        }
+    if (m_use_bbox_filter && !Map_bbox.contains(node_loc)) {
+        return;
     }
     
-    data_collector.nodes[node.id()] = MyData::Point(
-        node_loc.lat(), 
-        node_loc.lon(), 
-        node.id()
-    );
+    if (!m_locations.empty() && node.id() < m_locations.back().first) {
+        m_locations_sorted = false;
+    }
+    m_locations.emplace_back(node.id(), node_loc);
+}
+
+void MyHandler::sort_locations() {
+    if (m_locations_sorted) return;
+    std::sort(m_locations.begin(), m_locations.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    m_locations_sorted = true;
+}
+
+const osmium::Location* MyHandler::find_location(osmium::object_id_type node_id) const {
+    auto it = std::lower_bound(m_locations.begin(), m_locations.end(), node_id,
+        [](const auto& entry, osmium::object_id_type id) { return entry.first < id; });
+    return (it != m_locations.end() && it->first == node_id) ? &it->second : nullptr;
 }
 
 void MyHandler::connect_way_to_nodes(osmium::object_id_type way_id, 
@@ -110,76 +113,63 @@ void MyHandler::connect_way_to_nodes(osmium::object_id_type way_id,
 }
 
 void MyHandler::way(const osmium::Way& way) {
+    // Tri paresseux : fichiers non triés ou ways lus avant la fin des nodes
+    sort_locations();
+    
+    std::vector<WaySegment> segments;
+    segment_way(way, segments);
+    add_segments(segments);
+}
+
+void MyHandler::segment_way(const osmium::Way& way, std::vector<WaySegment>& segments) const {
     if (way.nodes().empty()) return;
     if (!is_valid_way_type(way)) return;
     
-    if (m_use_bbox_filter) {
-        bool intersects_bbox = false;
-        for (const auto& node_ref : way.nodes()) {
-            auto it = m_node_locations.find(node_ref.ref());
-            if (it != m_node_locations.end() && Map_bbox.contains(it->second)) {
-                intersects_bbox = true;
-                break;
-            }
-        }
-        if (!intersects_bbox) return;
-    }
-
-    // Collecter les IDs des nodes valides
-    std::vector<osmium::object_id_type> valid_node_ids;
+    // Collecter les nodes valides (dans la bbox) ; moins de deux : way hors de la bbox
+    std::vector<std::pair<osmium::object_id_type, osmium::Location>> valid_nodes;
     for (const auto& node_ref : way.nodes()) {
-        auto it = data_collector.nodes.find(node_ref.ref());
-        if (it != data_collector.nodes.end()) {
-            valid_node_ids.push_back(node_ref.ref());
+        if (const osmium::Location* location = find_location(node_ref.ref())) {
+            valid_nodes.emplace_back(node_ref.ref(), *location);
         }
     }
     
-    if (valid_node_ids.size() < 2) return;
+    if (valid_nodes.size() < 2) return;
+    
+    // Segmentation en ways à 2 nodes ; le premier segment garde l'id OSM
+    osmium::object_id_type base_way_id = way.id();
+    
+    for (size_t i = 0; i + 1 < valid_nodes.size(); ++i) {
+        const auto& [node1_id, location1] = valid_nodes[i];
+        const auto& [node2_id, location2] = valid_nodes[i + 1];
+        
+        segments.push_back(WaySegment{
+            (i == 0) ? base_way_id : generate_new_way_id(base_way_id, i),
+            node1_id,
+            node2_id,
+            location1,
+            location2,
+            static_cast<float>(calculate_haversine_distance(
+                location1.lat(), location1.lon(), location2.lat(), location2.lon()
+            ))
+        });
+    }
+}
 
-    if (valid_node_ids.size() == 2) {
-        // Way simple avec 2 nodes
-        MyData::Way current_way(way.id());
-        current_way.node1_id = valid_node_ids[0];
-        current_way.node2_id = valid_node_ids[1];
+void MyHandler::add_segments(const std::vector<WaySegment>& segments) {
+    for (const auto& segment : segments) {
+        // Les Points ne sont créés que pour les nodes des ways retenus
+        data_collector.nodes.try_emplace(segment.node1_id,
+            segment.location1.lat(), segment.location1.lon(), segment.node1_id);
+        data_collector.nodes.try_emplace(segment.node2_id,
+            segment.location2.lat(), segment.location2.lon(), segment.node2_id);
         
-        // Récupérer les points pour le calcul de distance
-        const auto& node1 = data_collector.nodes[valid_node_ids[0]];
-        const auto& node2 = data_collector.nodes[valid_node_ids[1]];
-        current_way.points = {node1, node2};
-        current_way.distance_meters = static_cast<float>(calculate_haversine_distance(
-            node1.lat, node1.lon, node2.lat, node2.lon
-        ));
+        MyData::Way segment_way(segment.id, segment.node1_id, segment.node2_id);
+        segment_way.distance_meters = segment.distance_meters;
         
-        // Ajouter le way
-        data_collector.ways[way.id()] = current_way;
+        data_collector.ways[segment.id] = std::move(segment_way);
         
         // CONNEXION IMMÉDIATE
-        connect_way_to_nodes(way.id(), current_way.node1_id, current_way.node2_id);
-        
-    } else {
-        // Segmentation pour ways avec 3+ nodes
-        osmium::object_id_type base_way_id = way.id();
-        
-        for (size_t i = 0; i < valid_node_ids.size() - 1; ++i) {
-            MyData::Way segment_way;
-            segment_way.id = (i == 0) ? base_way_id : generate_new_way_id(base_way_id, i);
-            segment_way.node1_id = valid_node_ids[i];
-            segment_way.node2_id = valid_node_ids[i + 1];
-            
-            // Récupérer les points pour le calcul
-            const auto& node1 = data_collector.nodes[valid_node_ids[i]];
-            const auto& node2 = data_collector.nodes[valid_node_ids[i + 1]];
-            segment_way.points = {node1, node2};
-            segment_way.distance_meters = static_cast<float>(calculate_haversine_distance(
-                node1.lat, node1.lon, node2.lat, node2.lon
-            ));
-            
-            // Ajouter le segment
-            data_collector.ways[segment_way.id] = segment_way;
-            
-            // CONNEXION IMMÉDIATE
-            connect_way_to_nodes(segment_way.id, segment_way.node1_id, segment_way.node2_id);
-        }
+        connect_way_to_nodes(segment.id, segment.node1_id, segment.node2_id);
     }
 }
 
@@ -187,47 +177,164 @@ void MyHandler::way(const osmium::Way& way) {
 // CRÉATION DE GEOBOX SIMPLIFIÉE
 // ====================================================================
 
+namespace {
+
+// Index des bbox demandées : rejet par l'enveloppe commune, puis bbox triées par
+// longitude minimale pour arrêter le parcours dès qu'elles commencent après le node
+class BBoxIndex {
+public:
+    explicit BBoxIndex(const std::vector<osmium::Box>& bboxes) {
+        for (size_t i = 0; i < bboxes.size(); ++i) {
+            envelope.extend(bboxes[i]);
+            sorted.emplace_back(bboxes[i], i);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.first.bottom_left().x() < b.first.bottom_left().x();
+        });
+    }
+    
+    template <typename F>
+    void for_each_containing(const osmium::Location& location, F&& f) const {
+        if (!envelope.contains(location)) return;
+        for (const auto& [box, index] : sorted) {
+            if (box.bottom_left().x() > location.x()) break;
+            if (box.contains(location)) f(index);
+        }
+    }
+    
+private:
+    osmium::Box envelope;
+    std::vector<std::pair<osmium::Box, size_t>> sorted;
+};
+
+} // namespace
+
 GeoBox create_geo_box(const std::string& osm_filename, 
                       double min_lon, double min_lat, 
-                      double max_lon, double max_lat) {
+                      double max_lon, double max_lat,
+                      int num_threads) {
     
-    std::cout << "Creating GeoBox from: " << osm_filename << std::endl;
-    std::cout << "BBox: (" << min_lon << ", " << min_lat << ") to (" << max_lon << ", " << max_lat << ")" << std::endl;
+    osmium::Box bbox;
+    bbox.extend(osmium::Location(min_lon, min_lat));
+    bbox.extend(osmium::Location(max_lon, max_lat));
+    
+    return std::move(create_geo_boxes(osm_filename, {bbox}, num_threads).front());
+}
+
+std::vector<GeoBox> create_geo_boxes(const std::string& osm_filename,
+                                     const std::vector<osmium::Box>& bboxes,
+                                     int num_threads) {
+    
+    std::cout << "Creating " << bboxes.size() << " GeoBox(es) from: " << osm_filename << std::endl;
+    for (const auto& bbox : bboxes) {
+        std::cout << "BBox: (" << bbox.bottom_left().lon() << ", " << bbox.bottom_left().lat() << ") to ("
+                  << bbox.top_right().lon() << ", " << bbox.top_right().lat() << ")" << std::endl;
+    }
+    
+    if (bboxes.empty()) return {};
     
     try {
-        MyHandler handler;
-        handler.set_bounding_box(min_lon, min_lat, max_lon, max_lat);
-        handler.enable_bounding_box_filter(true);
+        // Un handler par bbox ; chaque node n'est routé que vers les bbox qui le contiennent
+        std::vector<MyHandler> handlers(bboxes.size());
+        for (size_t h = 0; h < bboxes.size(); ++h) {
+            handlers[h].Map_bbox = bboxes[h];
+            handlers[h].enable_bounding_box_filter(true);
+        }
+        const BBoxIndex bbox_index(bboxes);
         
-        osmium::io::Reader reader(osm_filename, osmium::io::read_meta::no);
-        osmium::apply(reader, handler);
-        reader.close();
+        // Avec un index de blocs à jour (<pbf>.blkidx), seuls l'en-tête et les blocs touchant
+        // une des bbox sont lus ; le PBF réduit doit survivre au reader
+        std::string extracted;
+        osmium::io::File input_file(osm_filename);
+        if (auto index = PbfBlockIndex::load(PbfBlockIndex::index_path(osm_filename), osm_filename)) {
+            extracted = index->extract(osm_filename, bboxes);
+            if (!extracted.empty()) {
+                input_file = osmium::io::File(extracted.data(), extracted.size(), "pbf");
+            }
+        }
         
-        // NOTE: Plus besoin de boucle de connexion - fait automatiquement dans MyHandler::way()
+        // Les buffers sont décodés par les threads d'osmium ; les nodes sont indexés au fil
+        // de la lecture, les ways regroupés par lots segmentés en parallèle puis fusionnés
+        // dans l'ordre du fichier (résultat identique à une lecture séquentielle)
+        osmium::io::Reader reader(input_file, osmium::io::read_meta::no);
+        ThreadPool pool(num_threads);
+        const size_t batch_size = 4 * static_cast<size_t>(pool.size());
+        
+        std::vector<osmium::memory::Buffer> batch;
+        // batch_segments[h][i] : segments du buffer i pour la bbox h
+        std::vector<std::vector<std::vector<MyHandler::WaySegment>>> batch_segments(handlers.size());
         
-        // Nettoyage des nodes orphelins uniquement
-        auto nodes_it = handler.data_collector.nodes.begin();
-        while (nodes_it != handler.data_collector.nodes.end()) {
-            if (nodes_it->second.incident_ways.empty()) {
-                nodes_it = handler.data_collector.nodes.erase(nodes_it);
-            } else {
-                ++nodes_it;
+        auto flush_batch = [&]() {
+            if (batch.empty()) return;
+            for (auto& handler : handlers) {
+                handler.sort_locations();
+            }
+            
+            for (auto& segments : batch_segments) {
+                segments.assign(batch.size(), {});
+            }
+            pool.parallel_for(batch.size(), [&](size_t i, unsigned) {
+                for (const auto& way : batch[i].select<osmium::Way>()) {
+                    for (size_t h = 0; h < handlers.size(); ++h) {
+                        handlers[h].segment_way(way, batch_segments[h][i]);
+                    }
+                }
+            });
+            
+            for (size_t h = 0; h < handlers.size(); ++h) {
+                for (const auto& segments : batch_segments[h]) {
+                    handlers[h].add_segments(segments);
+                }
+            }
+            batch.clear();
+        };
+        
+        while (osmium::memory::Buffer buffer = reader.read()) {
+            bool has_ways = false;
+            for (const auto& item : buffer) {
+                if (item.type() == osmium::item_type::node) {
+                    const auto& node = static_cast<const osmium::Node&>(item);
+                    if (!node.location().valid()) continue;
+                    bbox_index.for_each_containing(node.location(), [&](size_t h) {
+                        handlers[h].node(node);
+                    });
+                } else if (item.type() == osmium::item_type::way) {
+                    has_ways = true;
+                }
+            }
+            
+            if (has_ways) {
+                batch.push_back(std::move(buffer));
+                if (batch.size() >= batch_size) flush_batch();
             }
         }
+        flush_batch();
         
-        std::cout << "Processing complete:" << std::endl;
-        std::cout << "  Nodes found: " << handler.data_collector.nodes.size() << std::endl;
-        std::cout << "  Ways found: " << handler.data_collector.ways.size() << std::endl;
-
-        GeoBox temp_box(handler.data_collector, handler.Map_bbox, osm_filename);
-        return connect_isolated_components(temp_box);
+        reader.close();
+        
+        // NOTE: Plus besoin de boucle de connexion - fait automatiquement dans MyHandler::way()
+        // ni de nettoyage des nodes orphelins : seuls les nodes des ways retenus sont créés
+        
+        std::vector<GeoBox> geo_boxes;
+        geo_boxes.reserve(handlers.size());
+        for (auto& handler : handlers) {
+            handler.release_locations();
+            
+            std::cout << "Processing complete:" << std::endl;
+            std::cout << "  Nodes found: " << handler.data_collector.nodes.size() << std::endl;
+            std::cout << "  Ways found: " << handler.data_collector.ways.size() << std::endl;
+            
+            GeoBox temp_box(std::move(handler.data_collector), handler.Map_bbox, osm_filename);
+            geo_boxes.push_back(connect_isolated_components(std::move(temp_box)));
+        }
+        return geo_boxes;
         
     } catch (const osmium::io_error& e) {
         std::cerr << "OSM I/O Error: " << e.what() << std::endl;
-        return GeoBox();
+        return std::vector<GeoBox>(bboxes.size());
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
-        return GeoBox();
+        return std::vector<GeoBox>(bboxes.size());
     }
 }
 
@@ -273,8 +380,11 @@ GeoBox apply_objectives(GeoBox geo_box, const FlickrConfig& flickr_config,
     int assigned_count = 0;
     std::unordered_set<osmium::object_id_type> assigned_nodes;
     
+    // Les nodes ne changent pas pendant l'affectation : un seul index pour tous les POI
+    const SpatialIndex node_index = SpatialIndex::build(geo_box.data);
+    
     for (const auto& poi : pois) {
-        osmium::object_id_type nearest_id = find_nearest_point(geo_box.data, poi.latitude, poi.longitude);
+        osmium::object_id_type nearest_id = find_nearest_point(node_index, poi.latitude, poi.longitude);
         
         if (nearest_id != 0) {
             auto it = geo_box.data.nodes.find(nearest_id);
@@ -297,6 +407,7 @@ GeoBox apply_objectives(GeoBox geo_box, const FlickrConfig& flickr_config,
     }
     
     geo_box.data.objective_groups[group_id].point_count = assigned_count;
+    geo_box.mark_modified();
     
     std::cout << "POIs Flickr récupérés: " << pois.size() << std::endl;
     std::cout << "Points assignés: " << assigned_count << std::endl;
@@ -502,35 +613,82 @@ GeoBox connect_isolated_components(GeoBox geo_box) {
     
     std::cout << "Composante principale: " << components[main_component_idx].size() << " nodes" << std::endl;
     
-    // Connecter chaque petite composante à la principale
+    // Index spatial sur la composante principale ; chaque îlot cherche en parallèle
+    // la paire de nodes la plus proche, les ways sont ensuite créés dans l'ordre
+    const SpatialIndex main_index = SpatialIndex::build(geo_box.data, components[main_component_idx]);
+    std::vector<std::tuple<osmium::object_id_type, osmium::object_id_type, double>> links(components.size());
+    
+    ThreadPool pool;
+    pool.parallel_for(components.size(), [&](size_t i, unsigned) {
+        if (i == main_component_idx) return;
+        links[i] = find_closest_nodes(geo_box.data, main_index, components[i]);
+    });
+    
     osmium::object_id_type next_way_id = get_max_way_id(geo_box.data) + 1;
     
     for (size_t i = 0; i < components.size(); ++i) {
         if (i == main_component_idx) continue;
         
-        auto [main_node, isolated_node, distance] = find_closest_nodes(
-            geo_box.data, components[main_component_idx], components[i]);
-            
+        auto [main_node, isolated_node, distance] = links[i];
+        
         std::cout << "Connexion composante " << i << " (distance: " << static_cast<int>(distance) << "m)" << std::endl;
         
         create_connecting_way(geo_box.data, next_way_id++, main_node, isolated_node, distance);
     }
+    geo_box.mark_modified();
     
     return geo_box;
 }
 
 std::vector<std::vector<osmium::object_id_type>> find_components_simple(const MyData& data) {
-    std::unordered_set<osmium::object_id_type> visited;
+    // Union-find sur les ways (union par taille, compression de chemin) : une passe
+    // sur les ways, sans construire l'adjacence
+    std::unordered_map<osmium::object_id_type, uint32_t> index_of;
+    std::vector<osmium::object_id_type> node_ids;
+    index_of.reserve(data.nodes.size());
+    node_ids.reserve(data.nodes.size());
+    for (const auto& [node_id, point] : data.nodes) {
+        index_of.emplace(node_id, static_cast<uint32_t>(node_ids.size()));
+        node_ids.push_back(node_id);
+    }
+    
+    std::vector<uint32_t> parent(node_ids.size());
+    std::vector<uint32_t> set_size(node_ids.size(), 1);
+    for (uint32_t u = 0; u < parent.size(); ++u) parent[u] = u;
+    
+    auto find = [&parent](uint32_t u) {
+        while (parent[u] != u) {
+            parent[u] = parent[parent[u]];
+            u = parent[u];
+        }
+        return u;
+    };
+    
+    for (const auto& [way_id, way] : data.ways) {
+        auto it1 = index_of.find(way.node1_id);
+        auto it2 = index_of.find(way.node2_id);
+        if (it1 == index_of.end() || it2 == index_of.end()) continue;
+        
+        uint32_t a = find(it1->second);
+        uint32_t b = find(it2->second);
+        if (a == b) continue;
+        if (set_size[a] < set_size[b]) std::swap(a, b);
+        parent[b] = a;
+        set_size[a] += set_size[b];
+    }
+    
+    // Regroupement par racine, composantes dans l'ordre de première apparition
+    std::vector<uint32_t> component_of(node_ids.size(), std::numeric_limits<uint32_t>::max());
     std::vector<std::vector<osmium::object_id_type>> components;
     
-    for (const auto& [node_id, node] : data.nodes) {
-        if (!visited.count(node_id)) {
-            std::vector<osmium::object_id_type> component;
-            bfs_explore(data, node_id, visited, component);
-            if (!component.empty()) {
-                components.push_back(component);
-            }
+    for (uint32_t u = 0; u < node_ids.size(); ++u) {
+        const uint32_t root = find(u);
+        if (component_of[root] == std::numeric_limits<uint32_t>::max()) {
+            component_of[root] = static_cast<uint32_t>(components.size());
+            components.emplace_back();
+            components.back().reserve(set_size[root]);
         }
+        components[component_of[root]].push_back(node_ids[u]);
     }
     
     return components;
@@ -584,28 +742,35 @@ find_closest_nodes(const MyData& data,
                   const std::vector<osmium::object_id_type>& comp1,
                   const std::vector<osmium::object_id_type>& comp2) {
     
+    // Indexer la plus grande des deux composantes, interroger depuis l'autre
+    if (comp2.size() > comp1.size()) {
+        auto [node2, node1, distance] = find_closest_nodes(data, SpatialIndex::build(data, comp2), comp1);
+        return std::make_tuple(node1, node2, distance);
+    }
+    return find_closest_nodes(data, SpatialIndex::build(data, comp1), comp2);
+}
+
+std::tuple<osmium::object_id_type, osmium::object_id_type, double> 
+find_closest_nodes(const MyData& data, 
+                  const SpatialIndex& comp1_index,
+                  const std::vector<osmium::object_id_type>& comp2) {
+    
     double min_distance = std::numeric_limits<double>::max();
     osmium::object_id_type best_node1 = 0;
     osmium::object_id_type best_node2 = 0;
     
-    for (const auto& node1_id : comp1) {
-        auto node1_it = data.nodes.find(node1_id);
-        if (node1_it == data.nodes.end()) continue;
+    for (const auto& node2_id : comp2) {
+        auto node2_it = data.nodes.find(node2_id);
+        if (node2_it == data.nodes.end()) continue;
         
-        for (const auto& node2_id : comp2) {
-            auto node2_it = data.nodes.find(node2_id);
-            if (node2_it == data.nodes.end()) continue;
-            
-            double distance = calculate_haversine_distance(
-                node1_it->second.lat, node1_it->second.lon,
-                node2_it->second.lat, node2_it->second.lon
-            );
-            
-            if (distance < min_distance) {
-                min_distance = distance;
-                best_node1 = node1_id;
-                best_node2 = node2_id;
-            }
+        double distance = 0.0;
+        osmium::object_id_type node1_id = comp1_index.nearest(
+            node2_it->second.lat, node2_it->second.lon, &distance);
+        
+        if (node1_id != 0 && distance < min_distance) {
+            min_distance = distance;
+            best_node1 = node1_id;
+            best_node2 = node2_id;
         }
     }
     
@@ -628,11 +793,10 @@ void create_connecting_way(MyData& data, osmium::object_id_type way_id,
     MyData::Way new_way(way_id);
     new_way.node1_id = node1_id;
     new_way.node2_id = node2_id;
-    new_way.points = {node1_it->second, node2_it->second};
     new_way.distance_meters = static_cast<float>(distance);
     
     // Ajouter le way aux données
-    data.ways[way_id] = new_way;
+    data.ways[way_id] = std::move(new_way);
     
     // CONNEXION IMMÉDIATE (cohérent avec MyHandler::way())
     node1_it->second.incident_ways.push_back(way_id);
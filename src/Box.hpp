@@ -1,6 +1,7 @@
 #ifndef BOX_HPP
 #define BOX_HPP
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 #include <unordered_map>
@@ -12,6 +13,9 @@
 #include <osmium/osm/way.hpp>
 #include <osmium/osm/box.hpp>
 #include <osmium/handler.hpp>
+#include "Common/GroupSet.hpp"
+
+class SpatialIndex;
 
 // Fonctions de validation
 bool is_valid_way_type(const osmium::Way& way);
@@ -83,7 +87,7 @@ struct MyData {
         osmium::object_id_type id = 0;
         std::vector<osmium::object_id_type> incident_ways;
         
-        std::unordered_set<int> groupes;  // Remplace int groupe
+        GroupSet groupes;  // Bitset des groupes (test d'appartenance en O(1) sans hachage)
         std::string objective_id = "";
         
         Point() = default;
@@ -113,14 +117,15 @@ struct MyData {
         }
     };
     
+    // Segment à 2 nodes ; sa géométrie est celle des Points node1_id / node2_id de
+    // MyData::nodes (aucune copie des extrémités dans le way)
     struct Way {
         osmium::object_id_type id;
         osmium::object_id_type node1_id;
         osmium::object_id_type node2_id;
-        std::vector<Point> points;
         float distance_meters = 0.0f;
         
-        std::unordered_set<int> groupes;  // Remplace int groupe
+        GroupSet groupes;  // Bitset des groupes (test d'appartenance en O(1) sans hachage)
         
         Way() : id(0), node1_id(0), node2_id(0) {}
         Way(osmium::object_id_type id) : id(id), node1_id(0), node2_id(0) {}
@@ -166,10 +171,17 @@ struct MyData {
 };
 
 // Handler OSM optimisé
+// Les nodes ne sont gardés que sous forme de positions compactes (id, Location) triées,
+// limitées à la bbox ; un MyData::Point n'est créé que pour les nodes des ways retenus.
+// La mémoire suit donc la taille de la GeoBox et non celle du fichier.
 class MyHandler : public osmium::handler::Handler {
 private:
     bool m_use_bbox_filter = false;
-    std::unordered_map<osmium::object_id_type, osmium::Location> m_node_locations;
+    std::vector<std::pair<osmium::object_id_type, osmium::Location>> m_locations;
+    bool m_locations_sorted = true;  // Fichiers PBF triés : nodes déjà par id croissant
+    
+    // Recherche dichotomique ; sort_locations() doit avoir été appelé
+    const osmium::Location* find_location(osmium::object_id_type node_id) const;
     
     double calculate_haversine_distance(double lat1, double lon1, double lat2, double lon2) const;
     
@@ -183,6 +195,16 @@ private:
                              osmium::object_id_type node2_id);
 
 public:
+    // Segment à 2 nodes d'un way OSM, produit sans toucher à data_collector
+    struct WaySegment {
+        osmium::object_id_type id;
+        osmium::object_id_type node1_id;
+        osmium::object_id_type node2_id;
+        osmium::Location location1;
+        osmium::Location location2;
+        float distance_meters;
+    };
+
     osmium::Box Map_bbox;
     MyData data_collector;
 
@@ -193,6 +215,16 @@ public:
     
     void node(const osmium::Node& node);
     void way(const osmium::Way& way);
+    
+    // Ingestion parallèle : segment_way (filtrage, segmentation, distances) est sans état
+    // partagé et peut tourner sur plusieurs threads une fois les positions triées ;
+    // add_segments fusionne ensuite les segments dans data_collector, dans l'ordre du fichier
+    void sort_locations();
+    void segment_way(const osmium::Way& way, std::vector<WaySegment>& segments) const;
+    void add_segments(const std::vector<WaySegment>& segments);
+    
+    // Libère l'index des positions une fois la lecture terminée
+    void release_locations() { std::vector<std::pair<osmium::object_id_type, osmium::Location>>().swap(m_locations); }
 };
 
 // Structure GeoBox
@@ -202,15 +234,39 @@ struct GeoBox {
     std::string source_file;
     bool is_valid = false;
     
+    // Identifiant du contenu de data, unique par construction et renouvelé par mark_modified() ;
+    // une copie non modifiée garde le même. Les instantanés dérivés (RoadGraph, SpatialIndex
+    // du Pathfinder) sont reconstruits quand il change
+    uint64_t generation = next_generation();
+    
+    // À appeler après toute modification en place des nodes, des ways ou des groupes des nodes
+    // (l'appartenance des ways aux groupes de chemins n'entre pas dans les instantanés)
+    void mark_modified() { generation = next_generation(); }
+    
+    static uint64_t next_generation() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+    
     GeoBox() = default;
     GeoBox(const MyData& d, const osmium::Box& b, const std::string& src) 
         : data(d), bbox(b), source_file(src), is_valid(true) {}
+    GeoBox(MyData&& d, const osmium::Box& b, const std::string& src) 
+        : data(std::move(d)), bbox(b), source_file(src), is_valid(true) {}
 };
 
 // Fonctions principales
+// num_threads : workers de segmentation des ways (<= 0 : tous les cœurs)
 GeoBox create_geo_box(const std::string& osm_filename, 
                       double min_lon, double min_lat, 
-                      double max_lon, double max_lat);
+                      double max_lon, double max_lat,
+                      int num_threads = 0);
+
+// Plusieurs GeoBox en une seule lecture du fichier (une par bbox, dans le même ordre) ;
+// les GeoBox invalides signalent une erreur de lecture
+std::vector<GeoBox> create_geo_boxes(const std::string& osm_filename,
+                                     const std::vector<osmium::Box>& bboxes,
+                                     int num_threads = 0);
 
 GeoBox apply_objectives(GeoBox geo_box, const FlickrConfig& flickr_config, 
                        const std::string& cache_filename, bool use_cache = true, int group_id = 1);
@@ -224,11 +280,18 @@ std::vector<std::vector<osmium::object_id_type>> find_components_simple(const My
 
 osmium::object_id_type get_max_way_id(const MyData& data);
 
+// Paire (node de comp1, node de comp2) la plus proche et sa distance
 std::tuple<osmium::object_id_type, osmium::object_id_type, double> 
 find_closest_nodes(const MyData& data, 
                   const std::vector<osmium::object_id_type>& comp1,
                   const std::vector<osmium::object_id_type>& comp2);
 
+// Variante avec un index spatial déjà construit sur comp1
+std::tuple<osmium::object_id_type, osmium::object_id_type, double> 
+find_closest_nodes(const MyData& data, 
+                  const SpatialIndex& comp1_index,
+                  const std::vector<osmium::object_id_type>& comp2);
+
 void create_connecting_way(MyData& data, osmium::object_id_type way_id, 
                           osmium::object_id_type node1_id, osmium::object_id_type node2_id, 
                           double distance);
@@ -0,0 +1,159 @@
+#ifndef GROUP_SET_HPP
+#define GROUP_SET_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <iterator>
+
+// Ensemble d'ids de groupes (>= 0) sous forme de bitset : les ids 0..63 tiennent dans
+// un masque inline, les ids plus grands dans un bitmap de débordement alloué à la
+// demande. Interface compatible avec l'ancien std::unordered_set<int> (insert, erase,
+// count, size, itération), parcours par ids croissants.
+class GroupSet {
+public:
+    static constexpr int INLINE_BITS = 64;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        const_iterator() = default;
+
+        int operator*() const { return word_index * INLINE_BITS + std::countr_zero(bits); }
+
+        const_iterator& operator++() {
+            bits &= bits - 1;
+            skip_empty_words();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++(*this);
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return word_index == other.word_index && bits == other.bits;
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class GroupSet;
+
+        const GroupSet* set = nullptr;
+        int word_index = 0;
+        uint64_t bits = 0;
+
+        const_iterator(const GroupSet* owner, int index) : set(owner), word_index(index) {
+            if (word_index < set->word_count()) {
+                bits = set->word(word_index);
+                skip_empty_words();
+            }
+        }
+
+        void skip_empty_words() {
+            while (bits == 0 && ++word_index < set->word_count()) {
+                bits = set->word(word_index);
+            }
+            if (bits == 0) word_index = set->word_count();
+        }
+    };
+
+    GroupSet() = default;
+
+    bool empty() const {
+        if (mask != 0) return false;
+        for (uint64_t w : overflow) {
+            if (w != 0) return false;
+        }
+        return true;
+    }
+
+    size_t size() const {
+        size_t total = std::popcount(mask);
+        for (uint64_t w : overflow) total += std::popcount(w);
+        return total;
+    }
+
+    // Test d'appartenance : un décalage et un ET pour les ids < 64
+    size_t count(int group) const {
+        if (group < 0) return 0;
+        if (group < INLINE_BITS) return (mask >> group) & 1u;
+        const size_t w = static_cast<size_t>(group / INLINE_BITS - 1);
+        return w < overflow.size() ? (overflow[w] >> (group % INLINE_BITS)) & 1u : 0;
+    }
+
+    bool contains(int group) const { return count(group) != 0; }
+
+    // Ids négatifs ignorés
+    void insert(int group) {
+        if (group < 0) return;
+        if (group < INLINE_BITS) {
+            mask |= uint64_t(1) << group;
+            return;
+        }
+        const size_t w = static_cast<size_t>(group / INLINE_BITS - 1);
+        if (w >= overflow.size()) overflow.resize(w + 1, 0);
+        overflow[w] |= uint64_t(1) << (group % INLINE_BITS);
+    }
+
+    void erase(int group) {
+        if (group < 0) return;
+        if (group < INLINE_BITS) {
+            mask &= ~(uint64_t(1) << group);
+            return;
+        }
+        const size_t w = static_cast<size_t>(group / INLINE_BITS - 1);
+        if (w < overflow.size()) overflow[w] &= ~(uint64_t(1) << (group % INLINE_BITS));
+    }
+
+    void clear() {
+        mask = 0;
+        overflow.clear();
+    }
+
+    // Ids 0..63 sous forme de masque (les ids plus grands n'y figurent pas)
+    uint64_t inline_mask() const { return mask; }
+    void insert_inline_mask(uint64_t bits) { mask |= bits; }
+
+    // Au moins un groupe commun
+    bool intersects(const GroupSet& other) const {
+        if (mask & other.mask) return true;
+        const size_t n = std::min(overflow.size(), other.overflow.size());
+        for (size_t w = 0; w < n; ++w) {
+            if (overflow[w] & other.overflow[w]) return true;
+        }
+        return false;
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, word_count()); }
+
+    bool operator==(const GroupSet& other) const {
+        if (mask != other.mask) return false;
+        const size_t n = std::max(overflow.size(), other.overflow.size());
+        for (size_t w = 0; w < n; ++w) {
+            const uint64_t a = w < overflow.size() ? overflow[w] : 0;
+            const uint64_t b = w < other.overflow.size() ? other.overflow[w] : 0;
+            if (a != b) return false;
+        }
+        return true;
+    }
+
+private:
+    uint64_t mask = 0;               // Ids 0..63
+    std::vector<uint64_t> overflow;  // overflow[w] : ids 64 * (w + 1) .. 64 * (w + 2) - 1
+
+    int word_count() const { return 1 + static_cast<int>(overflow.size()); }
+    uint64_t word(int index) const { return index == 0 ? mask : overflow[index - 1]; }
+};
+
+#endif // GROUP_SET_HPP
@@ -3,10 +3,19 @@
 
 #include "Box.hpp"
 
+// Combinaison asymétrique puis mélange (finaliseur splitmix64) : un simple XOR
+// donne le même hash pour (a, b) et (b, a) et 0 pour (a, a)
 struct PairHash {
     size_t operator()(const std::pair<osmium::object_id_type, osmium::object_id_type>& p) const {
-        return std::hash<osmium::object_id_type>{}(p.first) ^ std::hash<osmium::object_id_type>{}(p.second);
+        uint64_t h = static_cast<uint64_t>(std::hash<osmium::object_id_type>{}(p.first));
+        h ^= static_cast<uint64_t>(std::hash<osmium::object_id_type>{}(p.second)) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return static_cast<size_t>(h);
     }
 };
 
-#endif // HASHES_HPP
\ No newline at end of file
+#endif // HASHES_HPP
@@ -0,0 +1,111 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <latch>
+#include <algorithm>
+#include <exception>
+
+// Pool de threads minimal pour les calculs indépendants (matrices de distances, fourmis...)
+class ThreadPool {
+public:
+    // num_threads <= 0 : un thread par cœur disponible
+    explicit ThreadPool(int num_threads = 0) {
+        const unsigned count = resolve_thread_count(num_threads);
+        workers.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+    static unsigned resolve_thread_count(int requested) {
+        if (requested > 0) return static_cast<unsigned>(requested);
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Exécute body(index, slot) pour chaque index de [0, count) avec une distribution
+    // dynamique ; slot (0..size()-1) identifie l'état propre au worker. Bloquant.
+    // Une exception levée par body arrête la distribution des indices restants et est
+    // relancée dans le thread appelant (la première seulement) une fois tous les workers sortis.
+    template <typename Body>
+    void parallel_for(size_t count, Body&& body) {
+        if (count == 0) return;
+
+        const unsigned slots = static_cast<unsigned>(std::min<size_t>(size(), count));
+        std::atomic<size_t> next_index{0};
+        std::latch done(slots);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        for (unsigned slot = 0; slot < slots; ++slot) {
+            submit([&, slot] {
+                try {
+                    for (size_t i = next_index.fetch_add(1); i < count; i = next_index.fetch_add(1)) {
+                        body(i, slot);
+                    }
+                } catch (...) {
+                    next_index.store(count);
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                }
+                done.count_down();
+            });
+        }
+
+        done.wait();
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    bool stopping = false;
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            tasks.push(std::move(task));
+        }
+        queue_cv.notify_one();
+    }
+
+    void worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,465 @@
+#include "CompactGeoBox.hpp"
+#include <lz4.h>
+#include <lz4hc.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+constexpr char COMPACT_MAGIC[8] = {'G', 'E', 'O', 'B', 'O', 'X', 'Z', '\0'};
+
+// Identifiants de section (une section inconnue est ignorée à la lecture)
+enum Section : uint32_t {
+    NODE_IDS = 1,
+    NODE_COORDS,
+    NODE_EXACT_COORDS,
+    NODE_INCIDENT,
+    NODE_GROUPS,
+    NODE_OBJECTIVES,
+    WAY_IDS,
+    WAY_NODES,
+    WAY_DISTANCES,
+    WAY_GROUPS,
+    METADATA
+};
+
+struct SectionHeader {
+    uint32_t id;
+    uint32_t checksum;     // FNV-1a des octets décompressés
+    uint64_t raw_size;
+    uint64_t stored_size;  // == raw_size : section non compressée
+};
+
+uint32_t fnv1a(const std::string& bytes) {
+    uint32_t hash = 2166136261u;
+    for (char c : bytes) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class ByteWriter {
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<char>(value));
+    }
+
+    void delta(int64_t value, int64_t& previous) {
+        varint(zigzag(static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous))));
+        previous = value;
+    }
+
+    template <typename T>
+    void raw(const T& value) {
+        const char* data = reinterpret_cast<const char*>(&value);
+        bytes.append(data, sizeof(T));
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        bytes.append(value);
+    }
+
+    // Groupes par ids croissants : nombre puis écarts
+    void groups(const GroupSet& groupes) {
+        varint(groupes.size());
+        int previous = 0;
+        for (int group : groupes) {
+            varint(static_cast<uint64_t>(group - previous));
+            previous = group;
+        }
+    }
+
+    const std::string& data() const { return bytes; }
+
+private:
+    std::string bytes;
+};
+
+// Lecture bornée : toute lecture hors limites rend le lecteur invalide
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& bytes) : position(bytes.data()), end(bytes.data() + bytes.size()) {}
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position == end) break;
+            const auto byte = static_cast<uint8_t>(*position++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t delta(int64_t& previous) {
+        previous = static_cast<int64_t>(static_cast<uint64_t>(previous) + static_cast<uint64_t>(unzigzag(varint())));
+        return previous;
+    }
+
+    template <typename T>
+    T raw() {
+        T value{};
+        if (static_cast<size_t>(end - position) < sizeof(T)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    std::string string() {
+        const uint64_t length = varint();
+        if (!ok || length > static_cast<uint64_t>(end - position)) {
+            ok = false;
+            return {};
+        }
+        std::string value(position, static_cast<size_t>(length));
+        position += length;
+        return value;
+    }
+
+    void groups(GroupSet& groupes) {
+        const uint64_t count = varint();
+        int group = 0;
+        for (uint64_t i = 0; i < count && ok; ++i) {
+            group += static_cast<int>(varint());
+            groupes.insert(group);
+        }
+    }
+
+    // Nombre d'éléments annoncé, borné par les octets restants (un élément >= 1 octet)
+    uint64_t count() {
+        const uint64_t value = varint();
+        if (value > static_cast<uint64_t>(end - position) + 1) ok = false;
+        return ok ? value : 0;
+    }
+
+    bool good() const { return ok; }
+    bool at_end() const { return position == end; }
+
+private:
+    const char* position;
+    const char* end;
+    bool ok = true;
+};
+
+bool write_section(std::ofstream& out, Section id, const std::string& raw) {
+    SectionHeader header{id, fnv1a(raw), raw.size(), raw.size()};
+    if (raw.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) return false;
+
+    std::string compressed(static_cast<size_t>(LZ4_compressBound(static_cast<int>(raw.size()))), '\0');
+    const int stored = raw.empty() ? 0 : LZ4_compress_HC(raw.data(), compressed.data(), static_cast<int>(raw.size()),
+                                                         static_cast<int>(compressed.size()), LZ4HC_CLEVEL_DEFAULT);
+    const bool use_compressed = stored > 0 && static_cast<size_t>(stored) < raw.size();
+    if (use_compressed) header.stored_size = static_cast<uint64_t>(stored);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(use_compressed ? compressed.data() : raw.data(), static_cast<std::streamsize>(header.stored_size));
+    return static_cast<bool>(out);
+}
+
+bool read_section(std::ifstream& in, SectionHeader& header, std::string& raw) {
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.raw_size > static_cast<uint64_t>(LZ4_MAX_INPUT_SIZE) || header.stored_size > header.raw_size) return false;
+
+    std::string stored(static_cast<size_t>(header.stored_size), '\0');
+    if (!in.read(stored.data(), static_cast<std::streamsize>(stored.size()))) return false;
+
+    if (header.stored_size == header.raw_size) {
+        raw = std::move(stored);
+    } else {
+        raw.assign(static_cast<size_t>(header.raw_size), '\0');
+        const int decoded = LZ4_decompress_safe(stored.data(), raw.data(), static_cast<int>(stored.size()),
+                                                static_cast<int>(raw.size()));
+        if (decoded < 0 || static_cast<uint64_t>(decoded) != header.raw_size) return false;
+    }
+    return fnv1a(raw) == header.checksum;
+}
+
+} // namespace
+
+bool CompactGeoBox::write(const GeoBox& geo_box, const std::string& filepath) {
+    const MyData& data = geo_box.data;
+
+    std::vector<osmium::object_id_type> node_ids;
+    node_ids.reserve(data.nodes.size());
+    for (const auto& [node_id, point] : data.nodes) {
+        node_ids.push_back(node_id);
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+
+    std::vector<osmium::object_id_type> way_ids;
+    way_ids.reserve(data.ways.size());
+    for (const auto& [way_id, way] : data.ways) {
+        way_ids.push_back(way_id);
+    }
+    std::sort(way_ids.begin(), way_ids.end());
+
+    // Nodes : ids, coordonnées à virgule fixe, ways incidents, groupes, objective_id
+    ByteWriter ids, coords, exact_coords, incident, node_groups, objectives;
+    ids.varint(node_ids.size());
+    int64_t previous_id = 0, previous_x = 0, previous_y = 0, previous_way = 0, previous_exact = 0;
+    for (size_t i = 0; i < node_ids.size(); ++i) {
+        const MyData::Point& point = data.nodes.at(node_ids[i]);
+        ids.delta(node_ids[i], previous_id);
+
+        const osmium::Location location(point.lon, point.lat);
+        coords.delta(location.x(), previous_x);
+        coords.delta(location.y(), previous_y);
+        if (location.lon_without_check() != point.lon || location.lat_without_check() != point.lat) {
+            exact_coords.delta(static_cast<int64_t>(i), previous_exact);
+            exact_coords.raw(point.lon);
+            exact_coords.raw(point.lat);
+        }
+
+        incident.varint(point.incident_ways.size());
+        for (osmium::object_id_type way_id : point.incident_ways) {
+            incident.delta(way_id, previous_way);
+        }
+        node_groups.groups(point.groupes);
+        objectives.string(point.objective_id);
+    }
+
+    // Ways : ids, extrémités (écart au node2 du way précédent, puis node2 - node1),
+    // distances (float exact), groupes
+    ByteWriter way_id_bytes, way_nodes, distances, way_groups;
+    way_id_bytes.varint(way_ids.size());
+    int64_t previous_way_id = 0, previous_node = 0;
+    for (osmium::object_id_type way_id : way_ids) {
+        const MyData::Way& way = data.ways.at(way_id);
+        way_id_bytes.delta(way_id, previous_way_id);
+        way_nodes.delta(way.node1_id, previous_node);
+        way_nodes.delta(way.node2_id, previous_node);
+        distances.raw(way.distance_meters);
+        way_groups.groups(way.groupes);
+    }
+
+    // Métadonnées : bbox, fichier source, groupes d'objectifs
+    ByteWriter metadata;
+    metadata.raw(static_cast<uint8_t>(geo_box.bbox.valid() ? 1 : 0));
+    metadata.raw(geo_box.bbox.valid() ? geo_box.bbox.bottom_left().lon() : 0.0);
+    metadata.raw(geo_box.bbox.valid() ? geo_box.bbox.bottom_left().lat() : 0.0);
+    metadata.raw(geo_box.bbox.valid() ? geo_box.bbox.top_right().lon() : 0.0);
+    metadata.raw(geo_box.bbox.valid() ? geo_box.bbox.top_right().lat() : 0.0);
+    metadata.string(geo_box.source_file);
+    metadata.varint(data.objective_groups.size());
+    for (const auto& [group_id, group] : data.objective_groups) {
+        metadata.varint(zigzag(group_id));
+        metadata.varint(zigzag(group.id));
+        metadata.varint(zigzag(group.point_count));
+        metadata.string(group.name);
+        metadata.string(group.description);
+        metadata.varint(group.node_ids.size());
+        int64_t previous_member = 0;
+        for (osmium::object_id_type node_id : group.node_ids) {
+            metadata.delta(node_id, previous_member);
+        }
+    }
+
+    const std::pair<Section, const ByteWriter*> sections[] = {
+        {NODE_IDS, &ids}, {NODE_COORDS, &coords}, {NODE_EXACT_COORDS, &exact_coords},
+        {NODE_INCIDENT, &incident}, {NODE_GROUPS, &node_groups}, {NODE_OBJECTIVES, &objectives},
+        {WAY_IDS, &way_id_bytes}, {WAY_NODES, &way_nodes}, {WAY_DISTANCES, &distances},
+        {WAY_GROUPS, &way_groups}, {METADATA, &metadata}
+    };
+
+    const std::string temp_path = filepath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Cannot open file for writing: " << temp_path << std::endl;
+            return false;
+        }
+
+        const uint32_t version = FORMAT_VERSION;
+        const uint32_t section_count = static_cast<uint32_t>(std::size(sections));
+        out.write(COMPACT_MAGIC, sizeof(COMPACT_MAGIC));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&section_count), sizeof(section_count));
+
+        written = true;
+        for (const auto& [id, writer] : sections) {
+            if (!write_section(out, id, writer->data())) {
+                std::cerr << "Erreur d'écriture de la section " << id << ": " << temp_path << std::endl;
+                written = false;
+                break;
+            }
+        }
+        out.close();
+        if (written && out.fail()) {
+            std::cerr << "Erreur d'écriture: " << temp_path << std::endl;
+            written = false;
+        }
+    }
+    if (!written) {
+        std::error_code error;
+        std::filesystem::remove(temp_path, error);  // Ne pas laisser de .tmp partiel
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, filepath, error);
+    if (error) {
+        std::cerr << "Impossible de renommer " << temp_path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+bool CompactGeoBox::is_compact_cache(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(COMPACT_MAGIC)] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, COMPACT_MAGIC, sizeof(COMPACT_MAGIC)) == 0;
+}
+
+GeoBox CompactGeoBox::read(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(COMPACT_MAGIC)] = {};
+    uint32_t version = 0, section_count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, COMPACT_MAGIC, sizeof(COMPACT_MAGIC)) != 0
+        || !in.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != FORMAT_VERSION
+        || !in.read(reinterpret_cast<char*>(&section_count), sizeof(section_count))) {
+        return GeoBox();
+    }
+
+    std::unordered_map<uint32_t, std::string> sections;
+    for (uint32_t s = 0; s < section_count; ++s) {
+        SectionHeader header{};
+        std::string raw;
+        if (!read_section(in, header, raw)) {
+            std::cerr << "Section " << s << " illisible: " << filepath << std::endl;
+            return GeoBox();
+        }
+        sections[header.id] = std::move(raw);
+    }
+    for (uint32_t id = NODE_IDS; id <= METADATA; ++id) {
+        if (!sections.count(id)) return GeoBox();
+    }
+
+    GeoBox geo_box;
+    MyData& data = geo_box.data;
+
+    // Nodes
+    ByteReader ids(sections[NODE_IDS]), coords(sections[NODE_COORDS]), exact_coords(sections[NODE_EXACT_COORDS]);
+    ByteReader incident(sections[NODE_INCIDENT]), node_groups(sections[NODE_GROUPS]), objectives(sections[NODE_OBJECTIVES]);
+
+    const uint64_t node_count = ids.count();
+    std::vector<osmium::object_id_type> node_ids;
+    node_ids.reserve(node_count);
+    data.nodes.reserve(node_count);
+
+    int64_t previous_id = 0, previous_x = 0, previous_y = 0, previous_way = 0;
+    for (uint64_t i = 0; i < node_count && ids.good(); ++i) {
+        const osmium::object_id_type node_id = ids.delta(previous_id);
+        const auto x = static_cast<int32_t>(coords.delta(previous_x));  // x puis y : ordre du flux
+        const auto y = static_cast<int32_t>(coords.delta(previous_y));
+        const osmium::Location location(x, y);
+
+        MyData::Point point(location.lat_without_check(), location.lon_without_check(), node_id);
+        const uint64_t incident_count = incident.count();
+        point.incident_ways.reserve(incident_count);
+        for (uint64_t k = 0; k < incident_count; ++k) {
+            point.incident_ways.push_back(incident.delta(previous_way));
+        }
+        node_groups.groups(point.groupes);
+        point.objective_id = objectives.string();
+
+        node_ids.push_back(node_id);
+        data.nodes.emplace(node_id, std::move(point));
+    }
+
+    // Coordonnées non représentables en virgule fixe
+    int64_t exact_index = 0;
+    while (exact_coords.good() && !exact_coords.at_end()) {
+        exact_coords.delta(exact_index);
+        if (exact_index < 0 || static_cast<uint64_t>(exact_index) >= node_ids.size()) return GeoBox();
+        MyData::Point& point = data.nodes.at(node_ids[static_cast<size_t>(exact_index)]);
+        point.lon = exact_coords.raw<double>();
+        point.lat = exact_coords.raw<double>();
+    }
+
+    // Ways
+    ByteReader way_id_bytes(sections[WAY_IDS]), way_nodes(sections[WAY_NODES]);
+    ByteReader distances(sections[WAY_DISTANCES]), way_groups(sections[WAY_GROUPS]);
+
+    const uint64_t way_count = way_id_bytes.count();
+    data.ways.reserve(way_count);
+    int64_t previous_way_id = 0, previous_node = 0;
+    for (uint64_t i = 0; i < way_count && way_id_bytes.good(); ++i) {
+        const osmium::object_id_type way_id = way_id_bytes.delta(previous_way_id);
+        const osmium::object_id_type node1_id = way_nodes.delta(previous_node);
+        const osmium::object_id_type node2_id = way_nodes.delta(previous_node);
+
+        MyData::Way way(way_id, node1_id, node2_id);
+        way.distance_meters = distances.raw<float>();
+        way_groups.groups(way.groupes);
+        data.ways.emplace(way_id, std::move(way));
+    }
+
+    // Métadonnées
+    ByteReader metadata(sections[METADATA]);
+    const bool valid_box = metadata.raw<uint8_t>() != 0;
+    const double min_lon = metadata.raw<double>();
+    const double min_lat = metadata.raw<double>();
+    const double max_lon = metadata.raw<double>();
+    const double max_lat = metadata.raw<double>();
+    if (valid_box) {
+        geo_box.bbox.extend(osmium::Location(min_lon, min_lat));
+        geo_box.bbox.extend(osmium::Location(max_lon, max_lat));
+    }
+    geo_box.source_file = metadata.string();
+
+    const uint64_t group_count = metadata.count();
+    for (uint64_t g = 0; g < group_count && metadata.good(); ++g) {
+        const int group_id = static_cast<int>(unzigzag(metadata.varint()));
+        ObjectiveGroup group;
+        group.id = static_cast<int>(unzigzag(metadata.varint()));
+        group.point_count = static_cast<int>(unzigzag(metadata.varint()));
+        group.name = metadata.string();
+        group.description = metadata.string();
+        const uint64_t member_count = metadata.count();
+        group.node_ids.reserve(member_count);
+        int64_t previous_member = 0;
+        for (uint64_t k = 0; k < member_count; ++k) {
+            group.node_ids.push_back(metadata.delta(previous_member));
+        }
+        data.objective_groups[group_id] = std::move(group);
+    }
+
+    // Chaque section doit avoir été lue sans erreur et en entier : des octets restants
+    // signalent des compteurs incohérents avec le contenu
+    bool ok = true;
+    for (const ByteReader* reader : {&ids, &coords, &exact_coords, &incident, &node_groups, &objectives,
+                                     &way_id_bytes, &way_nodes, &distances, &way_groups, &metadata}) {
+        ok = ok && reader->good() && reader->at_end();
+    }
+    if (!ok) {
+        std::cerr << "Cache compact tronqué ou corrompu: " << filepath << std::endl;
+        return GeoBox();
+    }
+
+    geo_box.is_valid = true;
+    return geo_box;
+}
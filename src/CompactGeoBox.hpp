@@ -0,0 +1,27 @@
+#ifndef COMPACT_GEOBOX_HPP
+#define COMPACT_GEOBOX_HPP
+
+#include "Box.hpp"
+#include <string>
+
+// Cache compact d'une GeoBox (.gbz) pour l'archivage et les lectures à froid.
+// Nodes et ways sont triés par id ; ids, références et coordonnées sont codés en écarts
+// au précédent (zigzag + varint), les coordonnées en entiers 32 bits à 1e-7 degré comme
+// osmium::Location (les rares coordonnées non représentables sont conservées telles quelles).
+// Chaque section est compressée en un bloc LZ4 (HC) ; le fichier est lu séquentiellement,
+// contrairement à MappedGeoBox qui est projeté en mémoire sans décodage.
+class CompactGeoBox {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Écriture atomique (fichier temporaire puis renommage)
+    static bool write(const GeoBox& geo_box, const std::string& filepath);
+
+    // GeoBox invalide si le fichier est absent, tronqué ou d'une autre version
+    static GeoBox read(const std::string& filepath);
+
+    // Le fichier commence-t-il par la signature du format compact ?
+    static bool is_compact_cache(const std::string& filepath);
+};
+
+#endif // COMPACT_GEOBOX_HPP
@@ -0,0 +1,182 @@
+#include "GeoBoxCache.hpp"
+#include "GeoBoxManager.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+using json = nlohmann::json;
+
+// Octets lus au début et à la fin du fichier OSM : l'en-tête PBF (horodatage de l'extrait)
+// et le dernier bloc changent à chaque mise à jour, sans relire des Go de données
+constexpr size_t SAMPLE_BYTES = 1 << 20;
+
+constexpr int INDEX_VERSION = 1;
+
+class Fnv1a {
+public:
+    void add(const char* bytes, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(bytes[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    void add(const T& value) {
+        add(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void add(const std::string& value) {
+        add(static_cast<uint64_t>(value.size()));
+        add(value.data(), value.size());
+    }
+
+    uint64_t value() const { return hash; }
+
+private:
+    uint64_t hash = 14695981039346656037ull;
+};
+
+std::string index_path(const std::string& cache_dir) {
+    return (std::filesystem::path(cache_dir) / GeoBoxCache::INDEX_FILE).string();
+}
+
+// Index vide si absent ou illisible (il sera réécrit au prochain record)
+json load_index(const std::string& cache_dir) {
+    std::ifstream in(index_path(cache_dir));
+    if (in.is_open()) {
+        json index = json::parse(in, nullptr, false);
+        if (!index.is_discarded() && index.value("version", 0) == INDEX_VERSION
+            && index.contains("entries") && index["entries"].is_object()) {
+            return index;
+        }
+        std::cerr << "Index de cache illisible, reconstruit: " << index_path(cache_dir) << std::endl;
+    }
+    return json{{"version", INDEX_VERSION}, {"entries", json::object()}};
+}
+
+} // namespace
+
+std::string GeoBoxCache::workflow_options(bool use_flickr_objectives, const FlickrConfig& flickr_config) {
+    if (!use_flickr_objectives) {
+        return "objectives=0";
+    }
+    return "objectives=1;search=" + flickr_config.search_word + ";min_date=" + flickr_config.min_date
+         + ";max_date=" + flickr_config.max_date + ";radius=" + std::to_string(flickr_config.poi_assignment_radius);
+}
+
+std::string GeoBoxCache::make_key(const std::string& osm_file, const osmium::Box& bbox, const std::string& options) {
+    std::error_code error;
+    const uintmax_t file_size = std::filesystem::file_size(osm_file, error);
+    std::ifstream in(osm_file, std::ios::binary);
+    if (error || !in.is_open()) {
+        std::cerr << "Clé de cache impossible, fichier OSM illisible: " << osm_file << std::endl;
+        return {};
+    }
+
+    Fnv1a hash;
+    hash.add(static_cast<int32_t>(INGEST_VERSION));
+    hash.add(static_cast<uint64_t>(file_size));
+
+    std::string sample(static_cast<size_t>(std::min<uintmax_t>(SAMPLE_BYTES, file_size)), '\0');
+    in.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+    hash.add(sample.data(), static_cast<size_t>(in.gcount()));
+    if (file_size > SAMPLE_BYTES) {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(file_size - sample.size()));
+        in.read(sample.data(), static_cast<std::streamsize>(sample.size()));
+        hash.add(sample.data(), static_cast<size_t>(in.gcount()));
+    }
+
+    hash.add(static_cast<uint8_t>(bbox.valid()));
+    if (bbox.valid()) {
+        hash.add(bbox.bottom_left().x());
+        hash.add(bbox.bottom_left().y());
+        hash.add(bbox.top_right().x());
+        hash.add(bbox.top_right().y());
+    }
+    hash.add(options);
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash.value()));
+    return key;
+}
+
+std::string GeoBoxCache::entry_path(const std::string& cache_dir, const std::string& prefix, const std::string& key) {
+    return (std::filesystem::path(cache_dir) / GeoBoxManager::generate_cache_name(prefix + "_" + key)).string();
+}
+
+std::string GeoBoxCache::find(const std::string& cache_dir, const std::string& key) {
+    if (key.empty()) return {};
+
+    const json index = load_index(cache_dir);
+    auto entry = index["entries"].find(key);
+    if (entry == index["entries"].end() || !entry->contains("file")) return {};
+
+    const std::string cache_path = (std::filesystem::path(cache_dir) / (*entry)["file"].get<std::string>()).string();
+    return GeoBoxManager::cache_exists(cache_path) ? cache_path : std::string();
+}
+
+bool GeoBoxCache::record(const std::string& cache_dir, const std::string& key, const std::string& cache_path,
+                         const GeoBox& geo_box, const std::string& options) {
+    if (key.empty()) return false;
+
+    json index = load_index(cache_dir);
+    std::error_code error;
+    json entry;
+    entry["file"] = std::filesystem::path(cache_path).filename().string();
+    entry["source_file"] = geo_box.source_file;
+    entry["source_size"] = static_cast<uint64_t>(std::filesystem::file_size(geo_box.source_file, error));
+    entry["bbox"] = geo_box.bbox.valid()
+        ? json::array({geo_box.bbox.bottom_left().lon(), geo_box.bbox.bottom_left().lat(),
+                       geo_box.bbox.top_right().lon(), geo_box.bbox.top_right().lat()})
+        : json::array();
+    entry["options"] = options;
+    entry["ingest_version"] = INGEST_VERSION;
+    entry["created"] = std::time(nullptr);
+    entry["nodes_count"] = geo_box.data.nodes.size();
+    entry["ways_count"] = geo_box.data.ways.size();
+    index["entries"][key] = std::move(entry);
+
+    const std::string path = index_path(cache_dir);
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path);
+        if (!out.is_open()) {
+            std::cerr << "Cannot open file for writing: " << temp_path << std::endl;
+            return false;
+        }
+        out << index.dump(2);
+    }
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::cerr << "Impossible de renommer " << temp_path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+bool GeoBoxCache::publish(const std::string& cache_path, const std::string& alias_path) {
+    std::error_code error;
+    if (std::filesystem::equivalent(cache_path, alias_path, error)) {
+        return true;
+    }
+    std::filesystem::remove(alias_path, error);
+    std::filesystem::create_hard_link(cache_path, alias_path, error);
+    if (error) {
+        error.clear();
+        std::filesystem::copy_file(cache_path, alias_path, std::filesystem::copy_options::overwrite_existing, error);
+    }
+    if (error) {
+        std::cerr << "Impossible de publier " << cache_path << " sous " << alias_path << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef GEOBOX_CACHE_HPP
+#define GEOBOX_CACHE_HPP
+
+#include "Box.hpp"
+#include <string>
+
+// Caches de GeoBox adressés par leur contenu d'entrée.
+// La clé résume l'identité du fichier OSM (taille, empreinte du début et de la fin), la bbox
+// (entiers à 1e-7 degré, comme osmium::Location), la version du pipeline d'ingestion
+// (create_geo_box + connect_isolated_components) et les options du workflow (objectifs...).
+// Le dossier de cache contient un index JSON (INDEX_FILE) : clé -> fichier et métadonnées.
+// Une GeoBox déjà construite avec les mêmes entrées est rechargée au lieu d'être reconstruite.
+class GeoBoxCache {
+public:
+    static constexpr const char* INDEX_FILE = "geobox_index.json";
+
+    // À incrémenter quand la construction d'une GeoBox change (invalide toutes les clés)
+    static constexpr int INGEST_VERSION = 1;
+
+    // Options du workflow qui changent le contenu de la GeoBox, sous la forme utilisée par
+    // make_key et record : "objectives=0", ou les paramètres Flickr si des objectifs sont appliqués
+    static std::string workflow_options(bool use_flickr_objectives, const FlickrConfig& flickr_config = FlickrConfig());
+
+    // Clé hexadécimale (16 caractères) ; vide si le fichier OSM est illisible
+    static std::string make_key(const std::string& osm_file, const osmium::Box& bbox,
+                                const std::string& options);
+
+    // Fichier d'une entrée : <prefix>_<clé> + extension des caches binaires
+    static std::string entry_path(const std::string& cache_dir, const std::string& prefix, const std::string& key);
+
+    // Cache indexé pour cette clé, vide si absent (entrée inconnue ou fichier supprimé)
+    static std::string find(const std::string& cache_dir, const std::string& key);
+
+    // Ajoute ou remplace l'entrée (réécriture atomique de l'index)
+    static bool record(const std::string& cache_dir, const std::string& key, const std::string& cache_path,
+                       const GeoBox& geo_box, const std::string& options);
+
+    // Rend le cache accessible sous un nom lisible (lien physique, copie à défaut),
+    // pour les invites "Cache Name to load"
+    static bool publish(const std::string& cache_path, const std::string& alias_path);
+};
+
+#endif // GEOBOX_CACHE_HPP
@@ -2,10 +2,279 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <charconv>
+#include <algorithm>
+
+namespace {
+
+// Longueur maximale d'une chaîne d'overlays (protège contre une base qui se référence elle-même)
+constexpr size_t MAX_OVERLAY_DEPTH = 64;
+
+// Remplit une GeoBox au fil des événements SAX d'un cache JSON, sans construire le DOM :
+// seuls l'objet en cours (node, way ou groupe d'objectifs) et la pile des contextes
+// sont en mémoire. Même interprétation que deserialize_data (groupes 0 ignorés,
+// "groupe" des anciens caches, "points" des caches 1.0 sautés).
+class GeoBoxSaxReader : public nlohmann::json_sax<json> {
+public:
+    explicit GeoBoxSaxReader(GeoBox& geo_box) : geo_box(geo_box) {
+        geo_box.source_file = "unknown";
+        geo_box.is_valid = false;
+    }
+
+    const std::string& version() const { return cache_version; }
+    const std::string& error() const { return error_message; }
+
+    bool null() override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool boolean(bool value) override {
+        if (top() == Context::ROOT && current_key == "is_valid") geo_box.is_valid = value;
+        return true;
+    }
+
+    bool number_integer(number_integer_t value) override {
+        return number(static_cast<double>(value), static_cast<int64_t>(value));
+    }
+
+    bool number_unsigned(number_unsigned_t value) override {
+        return number(static_cast<double>(value), static_cast<int64_t>(value));
+    }
+
+    bool number_float(number_float_t value, const string_t&) override {
+        return number(value, static_cast<int64_t>(value));
+    }
+
+    bool string(string_t& value) override {
+        switch (top()) {
+            case Context::ROOT:
+                if (current_key == "source_file") geo_box.source_file = value;
+                else if (current_key == "version") cache_version = value;
+                break;
+            case Context::NODE:
+                if (current_key == "objective_id") point.objective_id = value;
+                break;
+            case Context::GROUP:
+                if (current_key == "name") group.name = value;
+                else if (current_key == "description") group.description = value;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool key(string_t& value) override {
+        current_key.assign(value);
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        Context context = Context::SKIP;
+        switch (top()) {
+            case Context::NONE: context = Context::ROOT; break;
+            case Context::ROOT:
+                if (current_key == "data") context = Context::DATA;
+                else if (current_key == "bbox") context = Context::BBOX;
+                break;
+            case Context::DATA:
+                if (current_key == "nodes") context = Context::NODES;
+                else if (current_key == "ways") context = Context::WAYS;
+                else if (current_key == "objective_groups") context = Context::GROUPS;
+                break;
+            case Context::NODES:
+                context = Context::NODE;
+                point = MyData::Point();
+                item_key = parse_id(current_key);
+                break;
+            case Context::WAYS:
+                context = Context::WAY;
+                way = MyData::Way();
+                item_key = parse_id(current_key);
+                break;
+            case Context::GROUPS:
+                context = Context::GROUP;
+                group = ObjectiveGroup();
+                item_key = parse_id(current_key);
+                break;
+            case Context::BBOX:
+                if (current_key == "bottom_left") context = Context::BOTTOM_LEFT;
+                else if (current_key == "top_right") context = Context::TOP_RIGHT;
+                break;
+            default:
+                break;
+        }
+        if (context == Context::NODE || context == Context::WAY) {
+            has_groupes = false;
+            legacy_group = 0;
+        }
+        contexts.push_back(context);
+        return true;
+    }
+
+    bool end_object() override {
+        const Context context = top();
+        contexts.pop_back();
+
+        switch (context) {
+            case Context::NODE:
+                if (!has_groupes) point.add_group(legacy_group);
+                geo_box.data.nodes.insert_or_assign(item_key, std::move(point));
+                break;
+            case Context::WAY:
+                if (!has_groupes) way.add_group(legacy_group);
+                geo_box.data.ways.insert_or_assign(item_key, std::move(way));
+                break;
+            case Context::GROUP:
+                geo_box.data.objective_groups.insert_or_assign(static_cast<int>(item_key), std::move(group));
+                break;
+            case Context::BOTTOM_LEFT: corners |= 1; break;
+            case Context::TOP_RIGHT: corners |= 2; break;
+            case Context::ROOT:
+                if (corners == 3) {
+                    geo_box.bbox.extend(osmium::Location(min_lon, min_lat));
+                    geo_box.bbox.extend(osmium::Location(max_lon, max_lat));
+                }
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        Context context = Context::SKIP;
+        if (top() == Context::NODE) {
+            if (current_key == "incident_ways") context = Context::INCIDENT_WAYS;
+            else if (current_key == "groupes") context = Context::NODE_GROUPS;
+        } else if (top() == Context::WAY) {
+            if (current_key == "groupes") context = Context::WAY_GROUPS;
+        } else if (top() == Context::GROUP) {
+            if (current_key == "node_ids") context = Context::GROUP_NODES;
+        }
+        if (context == Context::NODE_GROUPS || context == Context::WAY_GROUPS) has_groupes = true;
+        contexts.push_back(context);
+        return true;
+    }
+
+    bool end_array() override {
+        contexts.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& e) override {
+        error_message = "octet " + std::to_string(position) + ": " + e.what();
+        return false;
+    }
+
+private:
+    enum class Context {
+        NONE, ROOT, DATA, NODES, NODE, WAYS, WAY, GROUPS, GROUP, BBOX, BOTTOM_LEFT, TOP_RIGHT,
+        INCIDENT_WAYS, NODE_GROUPS, WAY_GROUPS, GROUP_NODES, SKIP
+    };
+
+    GeoBox& geo_box;
+    std::vector<Context> contexts;
+    std::string current_key;
+    std::string cache_version;
+    std::string error_message;
+
+    // Objet en cours de lecture
+    int64_t item_key = 0;
+    MyData::Point point;
+    MyData::Way way;
+    ObjectiveGroup group;
+    bool has_groupes = false;
+    int legacy_group = 0;
+
+    double min_lon = 0.0, min_lat = 0.0, max_lon = 0.0, max_lat = 0.0;
+    int corners = 0;  // Bit 0 : bottom_left lu, bit 1 : top_right lu
+
+    Context top() const { return contexts.empty() ? Context::NONE : contexts.back(); }
+
+    static int64_t parse_id(const std::string& text) {
+        int64_t id = 0;
+        std::from_chars(text.data(), text.data() + text.size(), id);
+        return id;
+    }
+
+    bool number(double real, int64_t integer) {
+        switch (top()) {
+            case Context::NODE:
+                if (current_key == "lat") point.lat = real;
+                else if (current_key == "lon") point.lon = real;
+                else if (current_key == "id") point.id = integer;
+                else if (current_key == "groupe") legacy_group = static_cast<int>(integer);
+                break;
+            case Context::WAY:
+                if (current_key == "id") way.id = integer;
+                else if (current_key == "node1_id") way.node1_id = integer;
+                else if (current_key == "node2_id") way.node2_id = integer;
+                else if (current_key == "distance_meters") way.distance_meters = static_cast<float>(real);
+                else if (current_key == "groupe") legacy_group = static_cast<int>(integer);
+                break;
+            case Context::GROUP:
+                if (current_key == "id") group.id = static_cast<int>(integer);
+                else if (current_key == "point_count") group.point_count = static_cast<int>(integer);
+                break;
+            case Context::BOTTOM_LEFT:
+                if (current_key == "lon") min_lon = real;
+                else if (current_key == "lat") min_lat = real;
+                break;
+            case Context::TOP_RIGHT:
+                if (current_key == "lon") max_lon = real;
+                else if (current_key == "lat") max_lat = real;
+                break;
+            case Context::INCIDENT_WAYS: point.incident_ways.push_back(integer); break;
+            case Context::NODE_GROUPS: point.add_group(static_cast<int>(integer)); break;
+            case Context::WAY_GROUPS: way.add_group(static_cast<int>(integer)); break;
+            case Context::GROUP_NODES: group.node_ids.push_back(integer); break;
+            default: break;
+        }
+        return true;
+    }
+};
+
+} // namespace
 
 // Sauvegarder une GeoBox
 bool GeoBoxManager::save_geobox(const GeoBox& geo_box, const std::string& filepath) {
-    std::cout << "=== Sauvegarde de GeoBox ===" << std::endl;
+    const std::filesystem::path extension = std::filesystem::path(filepath).extension();
+    const bool compact = extension == COMPACT_EXTENSION;
+    if (!compact && extension != CACHE_EXTENSION) {
+        return export_geobox_json(geo_box, filepath);
+    }
+    
+    std::cout << "=== Sauvegarde de GeoBox (" << (compact ? "compact" : "binaire") << ") ===" << std::endl;
+    std::cout << "Fichier: " << filepath << std::endl;
+    
+    if (!geo_box.is_valid) {
+        std::cerr << "Erreur: GeoBox invalide, impossible de sauvegarder" << std::endl;
+        return false;
+    }
+    
+    try {
+        const bool written = compact ? CompactGeoBox::write(geo_box, filepath)
+                                     : MappedGeoBox::write(geo_box, filepath);
+        if (!written) {
+            return false;
+        }
+        
+        std::cout << "GeoBox sauvegardée avec succès!" << std::endl;
+        std::cout << "  Nodes: " << geo_box.data.nodes.size() << std::endl;
+        std::cout << "  Ways: " << geo_box.data.ways.size() << std::endl;
+        std::cout << "  Objective groups: " << geo_box.data.objective_groups.size() << std::endl;
+        
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors de la sauvegarde: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Export JSON
+bool GeoBoxManager::export_geobox_json(const GeoBox& geo_box, const std::string& filepath) {
+    std::cout << "=== Sauvegarde de GeoBox (JSON) ===" << std::endl;
     std::cout << "Fichier: " << filepath << std::endl;
     
     if (!geo_box.is_valid) {
@@ -17,7 +286,7 @@ bool GeoBoxManager::save_geobox(const GeoBox& geo_box, const std::string& filepa
         json j;
         
         // Métadonnées
-        j["version"] = "1.0";
+        j["version"] = "1.1";  // 1.1 : plus de "points" dupliqués dans les ways
         j["timestamp"] = std::time(nullptr);
         j["source_file"] = geo_box.source_file;
         j["is_valid"] = geo_box.is_valid;
@@ -58,21 +327,170 @@ bool GeoBoxManager::save_geobox(const GeoBox& geo_box, const std::string& filepa
 
 // Récupérer une GeoBox sauvegardée
 GeoBox GeoBoxManager::load_geobox(const std::string& filepath) {
-    std::cout << "=== Chargement de GeoBox ===" << std::endl;
+    const std::string resolved = resolve_cache_path(filepath);
+    if (!cache_exists(resolved)) {
+        std::cout << "=== Chargement de GeoBox ===" << std::endl;
+        std::cout << "Fichier: " << filepath << std::endl;
+        std::cerr << "Erreur: Fichier de cache introuvable" << std::endl;
+        return GeoBox(); // GeoBox invalide
+    }
+    if (resolved != filepath) {
+        return load_geobox(resolved);
+    }
+    
+    if (GroupOverlay::is_overlay(filepath)) {
+        // Remonter la chaîne des overlays jusqu'au réseau de base, puis les appliquer dans l'ordre
+        std::vector<std::string> overlays{filepath};
+        std::string base = resolve_cache_path(GroupOverlay::base_path(filepath));
+        while (GroupOverlay::is_overlay(base) && overlays.size() < MAX_OVERLAY_DEPTH) {
+            overlays.push_back(base);
+            base = resolve_cache_path(GroupOverlay::base_path(base));
+        }
+        if (!cache_exists(base) || GroupOverlay::is_overlay(base)) {
+            std::cerr << "Erreur: base introuvable pour l'overlay " << filepath << std::endl;
+            return GeoBox(); // GeoBox invalide
+        }
+        
+        GeoBox geo_box = load_geobox(base);
+        std::reverse(overlays.begin(), overlays.end());
+        if (!geo_box.is_valid || !apply_overlays(geo_box, overlays)) {
+            return GeoBox(); // GeoBox invalide
+        }
+        return geo_box;
+    }
+    
+    if (CompactGeoBox::is_compact_cache(filepath)) {
+        std::cout << "=== Chargement de GeoBox (compact) ===" << std::endl;
+        std::cout << "Fichier: " << filepath << std::endl;
+        
+        GeoBox geo_box = CompactGeoBox::read(filepath);
+        if (!geo_box.is_valid) {
+            std::cerr << "Erreur: cache compact illisible ou d'une autre version" << std::endl;
+            return geo_box;
+        }
+        std::cout << "GeoBox chargée avec succès!" << std::endl;
+        std::cout << "  Nodes: " << geo_box.data.nodes.size() << std::endl;
+        std::cout << "  Ways: " << geo_box.data.ways.size() << std::endl;
+        std::cout << "  Objective groups: " << geo_box.data.objective_groups.size() << std::endl;
+        return geo_box;
+    }
+    
+    if (!MappedGeoBox::is_binary_cache(filepath)) {
+        return load_geobox_json(filepath);
+    }
+    
+    std::cout << "=== Chargement de GeoBox (binaire) ===" << std::endl;
     std::cout << "Fichier: " << filepath << std::endl;
     
-    if (!cache_exists(filepath)) {
-        std::cerr << "Erreur: Fichier de cache introuvable" << std::endl;
+    try {
+        MappedGeoBox mapped = MappedGeoBox::open(filepath);
+        if (!mapped.is_open()) {
+            std::cerr << "Erreur: cache binaire illisible ou d'une autre version" << std::endl;
+            return GeoBox(); // GeoBox invalide
+        }
+        
+        GeoBox geo_box = mapped.to_geobox();
+        std::cout << "GeoBox chargée avec succès!" << std::endl;
+        std::cout << "  Nodes: " << geo_box.data.nodes.size() << std::endl;
+        std::cout << "  Ways: " << geo_box.data.ways.size() << std::endl;
+        std::cout << "  Objective groups: " << geo_box.data.objective_groups.size() << std::endl;
+        return geo_box;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors du chargement: " << e.what() << std::endl;
         return GeoBox(); // GeoBox invalide
     }
+}
+
+// Sauvegarde incrémentale des groupes d'objectifs
+bool GeoBoxManager::save_overlay(const GeoBox& geo_box, const std::string& base_path, const std::string& filepath) {
+    std::cout << "=== Sauvegarde d'overlay ===" << std::endl;
+    std::cout << "Fichier: " << filepath << " (base: " << base_path << ")" << std::endl;
+    
+    if (!geo_box.is_valid) {
+        std::cerr << "Erreur: GeoBox invalide, impossible de sauvegarder" << std::endl;
+        return false;
+    }
+    
+    // Fichier réellement chargé (un .gbx absent peut désigner un overlay du même nom)
+    const std::string base = resolve_cache_path(base_path);
+    std::error_code error;
+    if (!cache_exists(base) || std::filesystem::equivalent(base, filepath, error)) {
+        std::cerr << "Erreur: base absente ou identique à l'overlay, choisissez un autre nom" << std::endl;
+        return false;
+    }
+    
+    std::vector<int> group_ids;
+    group_ids.reserve(geo_box.data.objective_groups.size());
+    for (const auto& [group_id, group] : geo_box.data.objective_groups) {
+        group_ids.push_back(group_id);
+    }
+    std::sort(group_ids.begin(), group_ids.end());
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (!GroupOverlay::write(geo_box, group_ids, base, filepath)) {
+        return false;
+    }
+    const double save_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    
+    std::cout << "Overlay sauvegardé avec succès!" << std::endl;
+    std::cout << "  Groupes: " << group_ids.size() << std::endl;
+    std::cout << "  Taille: " << std::filesystem::file_size(filepath) / 1024.0 << " Ko en " << save_ms << " ms" << std::endl;
+    return true;
+}
+
+// Empiler des overlays sur une GeoBox chargée
+bool GeoBoxManager::apply_overlays(GeoBox& geo_box, const std::vector<std::string>& overlay_paths) {
+    for (const std::string& overlay_path : overlay_paths) {
+        std::cout << "Application de l'overlay: " << overlay_path << std::endl;
+        if (!GroupOverlay::apply(geo_box, overlay_path)) {
+            std::cerr << "Erreur: overlay non appliqué" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "  Objective groups: " << geo_box.data.objective_groups.size() << std::endl;
+    return true;
+}
+
+// Projection d'un cache binaire
+MappedGeoBox GeoBoxManager::map_geobox(const std::string& filepath) {
+    MappedGeoBox mapped = MappedGeoBox::open(filepath);
+    if (!mapped.is_open()) {
+        std::cerr << "Erreur: projection impossible de " << filepath << std::endl;
+    }
+    return mapped;
+}
+
+// Lecture d'un cache JSON
+GeoBox GeoBoxManager::load_geobox_json(const std::string& filepath, bool streaming) {
+    std::cout << "=== Chargement de GeoBox (JSON) ===" << std::endl;
+    std::cout << "Fichier: " << filepath << std::endl;
     
     try {
-        std::ifstream file(filepath);
+        std::ifstream file(filepath, std::ios::binary);
         if (!file.is_open()) {
             std::cerr << "Cannot open file for reading: " << filepath << std::endl;
             return GeoBox(); // GeoBox invalide
         }
         
+        if (streaming) {
+            GeoBox geo_box;
+            GeoBoxSaxReader reader(geo_box);
+            if (!json::sax_parse(file, &reader)) {
+                std::cerr << "Erreur lors du chargement: " << reader.error() << std::endl;
+                return GeoBox(); // GeoBox invalide
+            }
+            
+            if (!reader.version().empty()) {
+                std::cout << "Cache version: " << reader.version() << std::endl;
+            }
+            std::cout << "GeoBox chargée avec succès!" << std::endl;
+            std::cout << "  Nodes: " << geo_box.data.nodes.size() << std::endl;
+            std::cout << "  Ways: " << geo_box.data.ways.size() << std::endl;
+            std::cout << "  Objective groups: " << geo_box.data.objective_groups.size() << std::endl;
+            return geo_box;
+        }
+        
         json j;
         file >> j;
         file.close();
@@ -106,6 +524,16 @@ GeoBox GeoBoxManager::load_geobox(const std::string& filepath) {
     }
 }
 
+// Réécrire un cache au format courant
+bool GeoBoxManager::migrate_cache(const std::string& filepath) {
+    GeoBox geo_box = load_geobox(filepath);
+    if (!geo_box.is_valid) {
+        std::cerr << "Migration impossible: " << filepath << std::endl;
+        return false;
+    }
+    return save_geobox(geo_box, std::filesystem::path(filepath).replace_extension(CACHE_EXTENSION).string());
+}
+
 // Rendre une GeoBox en carte
 bool GeoBoxManager::render_geobox(const GeoBox& geo_box, 
                                 const std::string& output_name,
@@ -138,6 +566,26 @@ bool GeoBoxManager::render_geobox(const GeoBox& geo_box,
 
 // === FONCTIONS UTILITAIRES ===
 
+// Résoudre le fichier de cache réellement lu
+std::string GeoBoxManager::resolve_cache_path(const std::string& filepath) {
+    if (filepath.empty() || cache_exists(filepath)) {
+        return filepath;
+    }
+    std::filesystem::path sibling(filepath);
+    if (sibling.extension() == CACHE_EXTENSION) {
+        if (cache_exists(sibling.replace_extension(OVERLAY_EXTENSION).string())) {
+            return sibling.string();
+        }
+        if (cache_exists(sibling.replace_extension(COMPACT_EXTENSION).string())) {
+            return sibling.string();
+        }
+        if (cache_exists(sibling.replace_extension(".json").string())) {
+            return sibling.string();
+        }
+    }
+    return filepath;
+}
+
 // Vérifier si un fichier de cache existe
 bool GeoBoxManager::cache_exists(const std::string& filepath) {
     return std::filesystem::exists(filepath);
@@ -146,7 +594,7 @@ bool GeoBoxManager::cache_exists(const std::string& filepath) {
 // Générer un nom de fichier de cache
 std::string GeoBoxManager::generate_cache_name(const std::string& prefix) {
     std::ostringstream oss;
-    oss << prefix << ".json";
+    oss << prefix << CACHE_EXTENSION;
     return oss.str();
 }
 
@@ -218,13 +666,6 @@ json GeoBoxManager::serialize_data(const MyData& data) {
             way_json["groupes"].push_back(group);
         }
         way_json["distance_meters"] = way.distance_meters;
-        way_json["points"] = json::array();
-        
-        for (const auto& point : way.points) {
-            json point_json;
-            point_json["id"] = point.id;
-            way_json["points"].push_back(point_json);
-        }
         
         ways_json[std::to_string(way_id)] = way_json;
     }
@@ -303,6 +744,7 @@ MyData GeoBoxManager::deserialize_data(const json& j) {
             way.node1_id = way_json["node1_id"];
             way.node2_id = way_json["node2_id"];
             way.distance_meters = way_json["distance_meters"];
+            // "points" (caches 1.0) est ignoré : la géométrie vient de node1_id / node2_id
             
             // MODIFIÉ: Désérialiser les groupes multiples
             way.groupes.clear();
@@ -3,10 +3,14 @@
 
 #include "Box.hpp"
 #include "MapRenderer.hpp"
+#include "MappedGeoBox.hpp"
+#include "CompactGeoBox.hpp"
+#include "GroupOverlay.hpp"
 #include <string>
 #include <fstream>
 #include <iostream>
 #include <ctime>
+#include <chrono>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 
@@ -14,13 +18,46 @@ using json = nlohmann::json;
 
 class GeoBoxManager {
 public:
+    // Extension des caches binaires (MappedGeoBox)
+    static constexpr const char* CACHE_EXTENSION = ".gbx";
     
-    // Sauvegarder une GeoBox
+    // Extension des caches compacts (CompactGeoBox), pour l'archivage
+    static constexpr const char* COMPACT_EXTENSION = ".gbz";
+    
+    // Extension des overlays de groupes (GroupOverlay)
+    static constexpr const char* OVERLAY_EXTENSION = ".gbo";
+    
+    // Sauvegarder une GeoBox : binaire si l'extension est CACHE_EXTENSION, compact si
+    // COMPACT_EXTENSION, JSON sinon
     static bool save_geobox(const GeoBox& geo_box, const std::string& filepath);
     
-    // Récupérer une GeoBox sauvegardée
+    // Export JSON (lisible, format historique)
+    static bool export_geobox_json(const GeoBox& geo_box, const std::string& filepath);
+    
+    // Sauvegarde incrémentale après pathfinding / métaheuristique : seuls les groupes
+    // d'objectifs (ways marqués, POI) sont écrits, au-dessus du cache base_path d'où
+    // geo_box a été chargée, sans réécrire le réseau
+    static bool save_overlay(const GeoBox& geo_box, const std::string& base_path, const std::string& filepath);
+    
+    // Empile des overlays (dans l'ordre) sur une GeoBox chargée ; s'arrête au premier échec
+    static bool apply_overlays(GeoBox& geo_box, const std::vector<std::string>& overlay_paths);
+    
+    // Récupérer une GeoBox sauvegardée (format détecté par la signature du fichier).
+    // Un overlay charge sa base (récursivement) puis applique ses groupes.
+    // Un cache .gbx absent est remplacé par l'overlay (.gbo), l'archive (.gbz) ou le .json du même nom s'il existe
     static GeoBox load_geobox(const std::string& filepath);
     
+    // Lecture d'un cache JSON. streaming : analyse SAX qui remplit MyData au fil des
+    // jetons, sans DOM ; sinon ancienne lecture via le DOM nlohmann (comparaison)
+    static GeoBox load_geobox_json(const std::string& filepath, bool streaming = true);
+    
+    // Projection en lecture seule d'un cache binaire, sans désérialisation
+    static MappedGeoBox map_geobox(const std::string& filepath);
+    
+    // Réécrire un cache d'une version antérieure au format courant : un cache JSON est
+    // converti en <nom>.gbx à côté de l'original, qui est conservé
+    static bool migrate_cache(const std::string& filepath);
+    
     // Rendre une GeoBox en carte
     static bool render_geobox(const GeoBox& geo_box, 
                             const std::string& output_name,
@@ -31,6 +68,9 @@ public:
     // Vérifier si un fichier de cache existe
     static bool cache_exists(const std::string& filepath);
     
+    // Fichier lu par load_geobox : un .gbx absent est remplacé par le .gbo, le .gbz, puis le .json du même nom
+    static std::string resolve_cache_path(const std::string& filepath);
+    
     // Générer un nom de fichier de cache
     static std::string generate_cache_name(const std::string& prefix = "geobox");
     
@@ -0,0 +1,259 @@
+#include "GroupOverlay.hpp"
+#include <lz4.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+constexpr char OVERLAY_MAGIC[8] = {'G', 'E', 'O', 'B', 'O', 'X', 'O', '\0'};
+
+struct OverlayHeader {
+    uint32_t version;
+    uint32_t layer_count;
+    uint64_t way_count;        // Ways de la base
+    uint64_t way_fingerprint;  // FNV-1a des ids et extrémités des ways de la base
+};
+
+// Ids des ways de la base par ordre croissant : le rang d'un way est son bit dans les bitmaps
+std::vector<osmium::object_id_type> sorted_way_ids(const MyData& data) {
+    std::vector<osmium::object_id_type> way_ids;
+    way_ids.reserve(data.ways.size());
+    for (const auto& [way_id, way] : data.ways) {
+        way_ids.push_back(way_id);
+    }
+    std::sort(way_ids.begin(), way_ids.end());
+    return way_ids;
+}
+
+uint64_t way_fingerprint(const MyData& data, const std::vector<osmium::object_id_type>& way_ids) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](int64_t value) {
+        for (int b = 0; b < 8; ++b) {
+            hash ^= static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * b));
+            hash *= 1099511628211ull;
+        }
+    };
+    for (osmium::object_id_type way_id : way_ids) {
+        const MyData::Way& way = data.ways.at(way_id);
+        mix(way_id);
+        mix(way.node1_id);
+        mix(way.node2_id);
+    }
+    return hash;
+}
+
+template <typename T>
+void write_raw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_string(std::ofstream& out, const std::string& value) {
+    write_raw(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template <typename T>
+bool read_raw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool read_string(std::ifstream& in, std::string& value) {
+    uint32_t length = 0;
+    if (!read_raw(in, length) || length > (1u << 24)) return false;
+    value.resize(length);
+    return static_cast<bool>(in.read(value.data(), length));
+}
+
+struct Layer {
+    int group_id = 0;
+    ObjectiveGroup group;
+    std::string bitmap;  // Bit i : way de rang i dans le groupe
+};
+
+// Lecture complète (en-tête, base, couches) avant toute modification de la GeoBox
+bool read_overlay(const std::string& filepath, OverlayHeader& header, std::string& base, std::vector<Layer>& layers) {
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(OVERLAY_MAGIC)] = {};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC)) != 0
+        || !read_raw(in, header) || header.version != GroupOverlay::FORMAT_VERSION || !read_string(in, base)) {
+        return false;
+    }
+
+    const uint64_t bitmap_bytes = (header.way_count + 7) / 8;
+    if (bitmap_bytes > static_cast<uint64_t>(LZ4_MAX_INPUT_SIZE) || header.layer_count > (1u << 16)) return false;
+
+    layers.resize(header.layer_count);
+    for (Layer& layer : layers) {
+        int32_t group_id = 0, id = 0, point_count = 0;
+        uint32_t node_count = 0, stored_size = 0;
+        if (!read_raw(in, group_id) || !read_raw(in, id) || !read_raw(in, point_count)
+            || !read_string(in, layer.group.name) || !read_string(in, layer.group.description)
+            || !read_raw(in, node_count) || node_count > (1u << 24)) {
+            return false;
+        }
+        layer.group_id = group_id;
+        layer.group.id = id;
+        layer.group.point_count = point_count;
+        layer.group.node_ids.resize(node_count);
+        if (!in.read(reinterpret_cast<char*>(layer.group.node_ids.data()),
+                     static_cast<std::streamsize>(node_count * sizeof(osmium::object_id_type)))
+            || !read_raw(in, stored_size) || stored_size > static_cast<uint32_t>(LZ4_compressBound(static_cast<int>(bitmap_bytes)))) {
+            return false;
+        }
+
+        std::string stored(stored_size, '\0');
+        if (!in.read(stored.data(), stored_size)) return false;
+        layer.bitmap.assign(static_cast<size_t>(bitmap_bytes), '\0');
+        const int decoded = LZ4_decompress_safe(stored.data(), layer.bitmap.data(), static_cast<int>(stored.size()),
+                                                static_cast<int>(layer.bitmap.size()));
+        if (decoded < 0 || static_cast<uint64_t>(decoded) != bitmap_bytes) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool GroupOverlay::write(const GeoBox& geo_box, const std::vector<int>& group_ids,
+                         const std::string& base_path, const std::string& filepath) {
+    const MyData& data = geo_box.data;
+    const std::vector<osmium::object_id_type> way_ids = sorted_way_ids(data);
+
+    OverlayHeader header{FORMAT_VERSION, static_cast<uint32_t>(group_ids.size()),
+                         way_ids.size(), way_fingerprint(data, way_ids)};
+
+    // Base dans le même dossier : nom seul, pour pouvoir déplacer le dossier de cache
+    const std::filesystem::path base(base_path);
+    const std::filesystem::path overlay(filepath);
+    const std::string stored_base = base.parent_path() == overlay.parent_path() ? base.filename().string() : base.string();
+
+    const size_t bitmap_bytes = (way_ids.size() + 7) / 8;
+    if (bitmap_bytes > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) return false;
+
+    const std::string temp_path = filepath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Cannot open file for writing: " << temp_path << std::endl;
+            return false;
+        }
+        out.write(OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC));
+        write_raw(out, header);
+        write_string(out, stored_base);
+
+        // Bitmaps de toutes les couches en un seul parcours des ways
+        std::unordered_map<int, size_t> layer_of;
+        for (size_t l = 0; l < group_ids.size(); ++l) {
+            layer_of.emplace(group_ids[l], l);
+        }
+        std::vector<std::string> bitmaps(group_ids.size(), std::string(bitmap_bytes, '\0'));
+        for (size_t rank = 0; rank < way_ids.size(); ++rank) {
+            for (int group : data.ways.at(way_ids[rank]).groupes) {
+                auto layer = layer_of.find(group);
+                if (layer != layer_of.end()) {
+                    bitmaps[layer->second][rank / 8] |= static_cast<char>(1u << (rank % 8));
+                }
+            }
+        }
+
+        std::string compressed(static_cast<size_t>(LZ4_compressBound(static_cast<int>(bitmap_bytes))), '\0');
+        for (size_t l = 0; l < group_ids.size(); ++l) {
+            const int group_id = group_ids[l];
+            const std::string& bitmap = bitmaps[l];
+            const int stored = LZ4_compress_default(bitmap.data(), compressed.data(), static_cast<int>(bitmap.size()),
+                                                    static_cast<int>(compressed.size()));
+            if (stored < 0 || (stored == 0 && !bitmap.empty())) {
+                out.setstate(std::ios::failbit);  // Traité comme une erreur d'écriture ci-dessous
+                break;
+            }
+
+            ObjectiveGroup group;
+            auto group_it = data.objective_groups.find(group_id);
+            if (group_it != data.objective_groups.end()) group = group_it->second;
+
+            write_raw(out, static_cast<int32_t>(group_id));
+            write_raw(out, static_cast<int32_t>(group_it != data.objective_groups.end() ? group.id : group_id));
+            write_raw(out, static_cast<int32_t>(group.point_count));
+            write_string(out, group.name);
+            write_string(out, group.description);
+            write_raw(out, static_cast<uint32_t>(group.node_ids.size()));
+            out.write(reinterpret_cast<const char*>(group.node_ids.data()),
+                      static_cast<std::streamsize>(group.node_ids.size() * sizeof(osmium::object_id_type)));
+            write_raw(out, static_cast<uint32_t>(stored));
+            out.write(compressed.data(), stored);
+        }
+        out.close();
+        written = !out.fail();
+        if (!written) std::cerr << "Erreur d'écriture: " << temp_path << std::endl;
+    }
+    if (!written) {
+        std::error_code error;
+        std::filesystem::remove(temp_path, error);  // Ne pas laisser de .tmp partiel
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, filepath, error);
+    if (error) {
+        std::cerr << "Impossible de renommer " << temp_path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+bool GroupOverlay::apply(GeoBox& geo_box, const std::string& filepath) {
+    OverlayHeader header{};
+    std::string base;
+    std::vector<Layer> layers;
+    if (!read_overlay(filepath, header, base, layers)) {
+        std::cerr << "Overlay illisible ou d'une autre version: " << filepath << std::endl;
+        return false;
+    }
+
+    MyData& data = geo_box.data;
+    const std::vector<osmium::object_id_type> way_ids = sorted_way_ids(data);
+    if (way_ids.size() != header.way_count || way_fingerprint(data, way_ids) != header.way_fingerprint) {
+        std::cerr << "Overlay " << filepath << " : le réseau ne correspond pas à la base chargée" << std::endl;
+        return false;
+    }
+
+    for (size_t rank = 0; rank < way_ids.size(); ++rank) {
+        MyData::Way& way = data.ways.at(way_ids[rank]);
+        for (const Layer& layer : layers) {
+            if ((static_cast<uint8_t>(layer.bitmap[rank / 8]) >> (rank % 8)) & 1u) {
+                way.add_group(layer.group_id);
+            } else {
+                way.groupes.erase(layer.group_id);
+            }
+        }
+    }
+    for (Layer& layer : layers) {
+        data.objective_groups[layer.group_id] = std::move(layer.group);
+    }
+    return true;
+}
+
+std::string GroupOverlay::base_path(const std::string& filepath) {
+    OverlayHeader header{};
+    std::string base;
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(OVERLAY_MAGIC)] = {};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC)) != 0
+        || !read_raw(in, header) || header.version != FORMAT_VERSION || !read_string(in, base)) {
+        return {};
+    }
+    const std::filesystem::path path(base);
+    return path.is_absolute() || path.has_parent_path() ? base
+                                                        : (std::filesystem::path(filepath).parent_path() / path).string();
+}
+
+bool GroupOverlay::is_overlay(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(OVERLAY_MAGIC)] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, OVERLAY_MAGIC, sizeof(OVERLAY_MAGIC)) == 0;
+}
@@ -0,0 +1,35 @@
+#ifndef GROUP_OVERLAY_HPP
+#define GROUP_OVERLAY_HPP
+
+#include "Box.hpp"
+#include <string>
+#include <vector>
+
+// Résultat de pathfinding / métaheuristique enregistré au-dessus d'une GeoBox de base (.gbo).
+// Le réseau routier n'est pas réécrit : chaque couche contient l'id du groupe, la bitmap
+// d'appartenance des ways (rang dans les ids de ways croissants de la base, compressée LZ4)
+// et le groupe d'objectifs (POI du tour). L'overlay référence le cache de base, qui peut
+// lui-même être un overlay : load_geobox remonte la chaîne puis applique les couches dans l'ordre.
+// Une empreinte des ways de la base refuse l'application sur un autre réseau.
+class GroupOverlay {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Écriture atomique des groupes group_ids de geo_box ; base_path est le cache d'où
+    // geo_box a été chargée (stocké relativement au dossier de l'overlay s'il s'y trouve)
+    static bool write(const GeoBox& geo_box, const std::vector<int>& group_ids,
+                      const std::string& base_path, const std::string& filepath);
+
+    // Applique les couches : pour chaque groupe, l'appartenance des ways est remplacée par
+    // celle de l'overlay. false (geo_box inchangée) si le fichier est illisible ou si le
+    // réseau ne correspond pas à la base
+    static bool apply(GeoBox& geo_box, const std::string& filepath);
+
+    // Cache de base référencé (chemin résolu), vide si le fichier n'est pas un overlay lisible
+    static std::string base_path(const std::string& filepath);
+
+    // Le fichier commence-t-il par la signature des overlays ?
+    static bool is_overlay(const std::string& filepath);
+};
+
+#endif // GROUP_OVERLAY_HPP
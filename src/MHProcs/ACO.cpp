@@ -1,13 +1,14 @@
 #include "ACO.hpp"
 #include "../Pathfinding.hpp"  // Pour accéder à A_Star_Search
+#include "../Common/ThreadPool.hpp"
 #include <iostream>
 #include <algorithm>
 #include <limits>
 #include <cmath>
-#include <cstdlib>
+#include <chrono>
 
 // Constructeur
-ACOSolver::ACOSolver(GeoBox& box) : geo_box(box) {}
+ACOSolver::ACOSolver(GeoBox& box) : geo_box(box), pathfinder(box) {}
 
 // Méthode principale ACO pour un groupe
 bool ACOSolver::solve_single_group(
@@ -23,65 +24,61 @@ bool ACOSolver::solve_single_group(
     std::cout << "\n=== ACO GROUPE " << group_id << " ===" << std::endl;
     std::cout << "POI à optimiser: " << objective_nodes.size() << std::endl;
 
-    // 1. Cache des distances entre POI
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash> distance_cache;
-    
+    // 1. Matrice des distances entre POI
     std::cout << "Calcul des distances entre POI..." << std::endl;
-    for (size_t i = 0; i < objective_nodes.size(); ++i) {
-        for (size_t j = i + 1; j < objective_nodes.size(); ++j) {
-            osmium::object_id_type node1 = objective_nodes[i];
-            osmium::object_id_type node2 = objective_nodes[j];
-            
-            // Utiliser le pathfinding pour calculer le chemin
-            std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
-            
-            double distance = 0.0;
-            if (!path.empty()) {
-                // Calculer la distance totale du chemin
-                for (const auto& way_id : path) {
-                    auto way_it = geo_box.data.ways.find(way_id);
-                    if (way_it != geo_box.data.ways.end()) {
-                        distance += way_it->second.distance_meters;
-                    }
-                }
-            } else {
-                // Si pas de chemin trouvé, distance infinie
-                distance = std::numeric_limits<double>::max();
-            }
-            
-            auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-            distance_cache[key] = distance;
-        }
+    
+    // Une recherche un-vers-plusieurs par POI au lieu d'un A* par paire ;
+    // les tours sont ensuite exprimés en indices de cette matrice
+    distance_matrix = DistanceMatrix::build(pathfinder, objective_nodes, params.num_threads);
+    const size_t n = distance_matrix.size();
+
+    // 2. Initialiser la matrice de phéromones et les poids heuristiques
+    pheromones.assign(n * n, params.initial_pheromone);
+    compute_heuristic(params);
+
+    // 3. Flux aléatoires : un par fourmi, dérivé de la graine maîtresse et de l'indice de
+    // la fourmi, pour des résultats identiques quel que soit le nombre de threads
+    const uint64_t master_seed = params.seed != 0
+        ? params.seed
+        : static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::cout << "Graine ACO: " << master_seed << std::endl;
+
+    std::vector<std::mt19937_64> ant_rngs;
+    ant_rngs.reserve(params.num_ants);
+    for (int k = 0; k < params.num_ants; ++k) {
+        std::seed_seq stream_seed{
+            static_cast<uint32_t>(master_seed), static_cast<uint32_t>(master_seed >> 32),
+            static_cast<uint32_t>(k)
+        };
+        ant_rngs.emplace_back(stream_seed);
     }
 
-    // 2. Initialiser la matrice de phéromones
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash> pheromones;
-    for (const auto& [key, distance] : distance_cache) {
-        pheromones[key] = params.initial_pheromone;
-    }
+    ThreadPool pool(params.num_threads);
+    compute_choice_info(params, pool);
 
-    // 3. Algorithme ACO principal
+    // 4. Algorithme ACO principal
     std::vector<Ant> ants(params.num_ants);
     Ant best_ant;
     best_ant.tour_length = std::numeric_limits<double>::max();
 
     for (int iteration = 0; iteration < params.max_iterations; ++iteration) {
         
-        // Chaque fourmi construit une solution
-        for (auto& ant : ants) {
-            ant.reset();
-            construct_ant_tour(ant, objective_nodes, distance_cache, pheromones, params);
-        }
+        // Chaque fourmi construit une solution (en parallèle)
+        pool.parallel_for(ants.size(), [&](size_t k, unsigned) {
+            ants[k].reset(n);
+            construct_ant_tour(ants[k], ant_rngs[k]);
+        });
 
         // Trouver la meilleure fourmi de cette itération
         for (const auto& ant : ants) {
-            if (ant.tour_length < best_ant.tour_length && ant.tour.size() == objective_nodes.size()) {
+            if (ant.tour_length < best_ant.tour_length && ant.tour.size() == n) {
                 best_ant = ant;
             }
         }
 
         // Mise à jour des phéromones
-        update_pheromones(pheromones, ants, params);
+        update_pheromones(ants, params);
+        compute_choice_info(params, pool);
 
         // Affichage du progrès
         if (iteration % 10 == 0 || iteration == params.max_iterations - 1) {
@@ -90,8 +87,8 @@ bool ACOSolver::solve_single_group(
         }
     }
 
-    // 4. Appliquer la meilleure solution trouvée
-    if (best_ant.tour.empty() || best_ant.tour.size() != objective_nodes.size()) {
+    // 5. Appliquer la meilleure solution trouvée
+    if (best_ant.tour.empty() || best_ant.tour.size() != n) {
         std::cout << "ACO Groupe " << group_id << ": Aucune solution valide trouvée" << std::endl;
         return false;
     }
@@ -107,114 +104,122 @@ bool ACOSolver::solve_single_group(
 // Construction d'un tour complet par une fourmi
 void ACOSolver::construct_ant_tour(
     Ant& ant,
-    const std::vector<osmium::object_id_type>& objective_nodes,
-    const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& distance_cache,
-    const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
-    const ACOParams& params) {
+    std::mt19937_64& rng) const {
+
+    const size_t n = distance_matrix.size();
 
     // Commencer par un POI aléatoire
-    int start_idx = rand() % objective_nodes.size();
-    osmium::object_id_type current_node = objective_nodes[start_idx];
+    size_t current_node = std::uniform_int_distribution<size_t>(0, n - 1)(rng);
     
     ant.tour.push_back(current_node);
-    ant.visited.insert(current_node);
+    ant.visited[current_node] = 1;
 
     // Visiter tous les autres POI
-    while (ant.visited.size() < objective_nodes.size()) {
-        osmium::object_id_type next_node = choose_next_node(
-            current_node, objective_nodes, ant.visited, distance_cache, pheromones, params);
+    while (ant.tour.size() < n) {
+        size_t next_node = choose_next_node(current_node, ant, rng);
         
-        if (next_node == 0) break; // Erreur - aucun nœud disponible
+        if (next_node == n) break; // Erreur - aucun nœud disponible
         
         ant.tour.push_back(next_node);
-        ant.visited.insert(next_node);
+        ant.visited[next_node] = 1;
         
         // Ajouter la distance au tour
-        auto key = std::make_pair(std::min(current_node, next_node), std::max(current_node, next_node));
-        auto dist_it = distance_cache.find(key);
-        if (dist_it != distance_cache.end()) {
-            ant.tour_length += dist_it->second;
-        }
+        ant.tour_length += distance_matrix.distance(current_node, next_node);
         
         current_node = next_node;
     }
 
     // Fermer le cycle (retour au point de départ)
-    if (ant.tour.size() == objective_nodes.size()) {
-        auto key = std::make_pair(std::min(current_node, ant.tour[0]), std::max(current_node, ant.tour[0]));
-        auto dist_it = distance_cache.find(key);
-        if (dist_it != distance_cache.end()) {
-            ant.tour_length += dist_it->second;
-        }
+    if (ant.tour.size() == n) {
+        ant.tour_length += distance_matrix.distance(current_node, ant.tour[0]);
     }
 }
 
 // Choix du prochain POI selon les probabilités ACO
-osmium::object_id_type ACOSolver::choose_next_node(
-    osmium::object_id_type current_node,
-    const std::vector<osmium::object_id_type>& objective_nodes,
-    const std::unordered_set<osmium::object_id_type>& visited,
-    const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& distance_cache,
-    const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
-    const ACOParams& params) {
+size_t ACOSolver::choose_next_node(
+    size_t current_node,
+    Ant& ant,
+    std::mt19937_64& rng) const {
 
-    std::vector<std::pair<osmium::object_id_type, double>> probabilities;
-    double total_probability = 0.0;
+    const size_t n = distance_matrix.size();
+    const double* choice_row = &choice_info[current_node * n];
+    const char* visited = ant.visited.data();
+    double* weights = ant.weights.data();
 
-    // Calculer les probabilités pour chaque POI non visité
-    for (const auto& candidate : objective_nodes) {
-        if (visited.count(candidate) == 0 && candidate != current_node) {
-            
-            auto key = std::make_pair(std::min(current_node, candidate), std::max(current_node, candidate));
-            
-            auto dist_it = distance_cache.find(key);
-            auto pher_it = pheromones.find(key);
-            
-            if (dist_it != distance_cache.end() && pher_it != pheromones.end() && 
-                dist_it->second > 0 && dist_it->second < std::numeric_limits<double>::max()) {
-                
-                double tau = std::pow(pher_it->second, params.alpha);
-                double eta = std::pow(1.0 / (dist_it->second + 1.0), params.beta);
-                double probability = tau * eta;
-                
-                probabilities.push_back(std::make_pair(candidate, probability));
-                total_probability += probability;
-            }
-        }
+    // Poids des POI non visités (boucle sans branchement, vectorisable)
+    double total_probability = 0.0;
+    for (size_t candidate = 0; candidate < n; ++candidate) {
+        weights[candidate] = visited[candidate] ? 0.0 : choice_row[candidate];
+        total_probability += weights[candidate];
     }
 
-    if (probabilities.empty() || total_probability <= 0.0) {
-        return 0; // Erreur
+    if (total_probability <= 0.0) {
+        return n; // Erreur
     }
 
     // Sélection par roulette
-    double random_value = ((double)rand() / RAND_MAX) * total_probability;
+    double random_value = std::uniform_real_distribution<double>(0.0, total_probability)(rng);
     double cumulative = 0.0;
+    size_t last_candidate = n;
 
-    for (const auto& [node_id, probability] : probabilities) {
-        cumulative += probability;
+    for (size_t candidate = 0; candidate < n; ++candidate) {
+        if (weights[candidate] <= 0.0) continue;
+        cumulative += weights[candidate];
+        last_candidate = candidate;
         if (cumulative >= random_value) {
-            return node_id;
+            return candidate;
         }
     }
 
-    // Fallback
-    return probabilities[0].first;
+    // Fallback (arrondis)
+    return last_candidate;
+}
+
+void ACOSolver::compute_heuristic(const ACOParams& params) {
+    const size_t n = distance_matrix.size();
+    heuristic.assign(n * n, 0.0);
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            const double distance = distance_matrix.distance(i, j);
+            if (i != j && distance > 0 && distance < DistanceMatrix::UNREACHABLE) {
+                heuristic[i * n + j] = std::pow(1.0 / (distance + 1.0), params.beta);
+            }
+        }
+    }
+}
+
+void ACOSolver::compute_choice_info(const ACOParams& params, ThreadPool& pool) {
+    const size_t n = distance_matrix.size();
+    choice_info.resize(n * n);
+
+    // Une ligne par tâche ; pow évité pour alpha = 1 (valeur par défaut)
+    const bool unit_alpha = (params.alpha == 1.0);
+    pool.parallel_for(n, [&](size_t i, unsigned) {
+        const double* pheromone_row = &pheromones[i * n];
+        const double* heuristic_row = &heuristic[i * n];
+        double* choice_row = &choice_info[i * n];
+        for (size_t j = 0; j < n; ++j) {
+            const double tau = unit_alpha ? pheromone_row[j] : std::pow(pheromone_row[j], params.alpha);
+            choice_row[j] = tau * heuristic_row[j];
+        }
+    });
 }
 
 // Mise à jour des phéromones
 void ACOSolver::update_pheromones(
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
     const std::vector<Ant>& ants,
     const ACOParams& params) {
 
+    const size_t n = distance_matrix.size();
+
     // Évaporation
-    for (auto& [key, pheromone] : pheromones) {
+    for (double& pheromone : pheromones) {
         pheromone *= (1.0 - params.rho);
         pheromone = std::max(pheromone, 0.1);
     }
 
-    // Dépôt par chaque fourmi
+    // Dépôt par chaque fourmi (matrice symétrique : les deux sens)
     for (const auto& ant : ants) {
         if (ant.tour.size() < 2 || ant.tour_length <= 0.0) continue;
         
@@ -223,22 +228,15 @@ void ACOSolver::update_pheromones(
         // Pour chaque arête du tour
         for (size_t i = 0; i < ant.tour.size(); ++i) {
             size_t next_i = (i + 1) % ant.tour.size();
-            auto key = std::make_pair(
-                std::min(ant.tour[i], ant.tour[next_i]), 
-                std::max(ant.tour[i], ant.tour[next_i])
-            );
-            
-            auto it = pheromones.find(key);
-            if (it != pheromones.end()) {
-                it->second += delta;
-            }
+            pheromones[ant.tour[i] * n + ant.tour[next_i]] += delta;
+            pheromones[ant.tour[next_i] * n + ant.tour[i]] += delta;
         }
     }
 }
 
 // Application du tour optimal aux ways
 void ACOSolver::apply_tour_to_ways(
-    const std::vector<osmium::object_id_type>& tour,
+    const Tour& tour,
     int group_id) {
 
     std::cout << "Application du tour aux ways du groupe " << group_id << "..." << std::endl;
@@ -247,11 +245,8 @@ void ACOSolver::apply_tour_to_ways(
     // Pour chaque segment du tour optimal
     for (size_t i = 0; i < tour.size(); ++i) {
         size_t next_i = (i + 1) % tour.size();
-        osmium::object_id_type node1 = tour[i];
-        osmium::object_id_type node2 = tour[next_i];
-
-        // Trouver le plus court chemin
-        std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
+        // Chemin reconstruit depuis les arbres de prédécesseurs de la matrice
+        std::vector<osmium::object_id_type> path = distance_matrix.path(tour[i], tour[next_i]);
         
         // Marquer tous les ways de ce chemin avec le groupe
         for (const auto& way_id : path) {
@@ -268,10 +263,7 @@ std::vector<osmium::object_id_type> ACOSolver::find_shortest_path(
     osmium::object_id_type start, 
     osmium::object_id_type end) {
     
-    // Créer un objet Pathfinder temporaire pour utiliser A_Star_Search
-    // NOTE: Cette approche nécessite que Pathfinder soit accessible
-    Pathfinder temp_pathfinder(geo_box);
-    return temp_pathfinder.A_Star_Search(start, end);
+    return pathfinder.A_Star_Search(start, end);
 }
 
 void ACOSolver::update_way_group(osmium::object_id_type way_id, int new_group) {
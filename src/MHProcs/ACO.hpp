@@ -2,23 +2,29 @@
 #define ACO_HPP
 
 #include "../Box.hpp"
-#include "../Common/Hashes.hpp"
+#include "../Pathfinding.hpp"
+#include "DistanceMatrix.hpp"
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <random>
+#include <cstdint>
+
+class ThreadPool;
 
 // Structure représentant une fourmi
 struct Ant {
-    std::vector<osmium::object_id_type> tour;
+    Tour tour;                  // Indices dans la matrice des distances
     double tour_length;
-    std::unordered_set<osmium::object_id_type> visited;
+    std::vector<char> visited;  // visited[i] : POI i déjà dans le tour
+    std::vector<double> weights;  // Tampon de la roulette, réutilisé à chaque pas
     
     Ant() : tour_length(0.0) {}
     
-    void reset() {
+    void reset(size_t num_nodes) {
         tour.clear();
+        tour.reserve(num_nodes);
         tour_length = 0.0;
-        visited.clear();
+        visited.assign(num_nodes, 0);
+        weights.resize(num_nodes);
     }
 };
 
@@ -31,17 +37,29 @@ struct ACOParams {
     double rho = 0.5;        // Taux d'évaporation
     double Q = 100.0;        // Constante de dépôt de phéromones
     double initial_pheromone = 1.0;
+    int num_threads = 0;     // Threads des distances et des fourmis (0 = tous les cœurs)
+    uint64_t seed = 0;       // Graine maîtresse, résultats reproductibles (0 = horloge)
     
     ACOParams() = default;
 };
 
-// Forward declaration de Pathfinder pour éviter les dépendances circulaires
-class Pathfinder;
-
 // Classe dédiée aux algorithmes ACO
 class ACOSolver {
 private:
     GeoBox& geo_box;
+    Pathfinder pathfinder;  // Réutilisé pour toutes les recherches (heuristique précalculée)
+    
+    // Matrice des distances (Dijkstra un-vers-plusieurs) et arbres de chemins
+    DistanceMatrix distance_matrix;
+
+    // Phéromones denses n x n (ligne majeure, symétrique)
+    std::vector<double> pheromones;
+
+    // η^β = (1 / (d + 1))^β, 0 pour les POI inatteignables ou confondus ; fixe par groupe
+    std::vector<double> heuristic;
+
+    // τ^α · η^β : poids de choix, recalculés une fois par itération après les phéromones
+    std::vector<double> choice_info;
 
 public:
     explicit ACOSolver(GeoBox& box);
@@ -54,32 +72,31 @@ public:
     );
 
 private:
-    // Méthodes internes ACO
+    // Méthodes internes ACO ; construction en parallèle (phéromones en lecture seule),
+    // chaque fourmi tirant dans son propre flux aléatoire
     void construct_ant_tour(
         Ant& ant,
-        const std::vector<osmium::object_id_type>& objective_nodes,
-        const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& distance_cache,
-        const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
-        const ACOParams& params
-    );
+        std::mt19937_64& rng
+    ) const;
 
-    osmium::object_id_type choose_next_node(
-        osmium::object_id_type current_node,
-        const std::vector<osmium::object_id_type>& objective_nodes,
-        const std::unordered_set<osmium::object_id_type>& visited,
-        const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& distance_cache,
-        const std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
-        const ACOParams& params
-    );
+    // Renvoie distance_matrix.size() si aucun POI n'est atteignable
+    size_t choose_next_node(
+        size_t current_node,
+        Ant& ant,
+        std::mt19937_64& rng
+    ) const;
+
+    void compute_heuristic(const ACOParams& params);
+    void compute_choice_info(const ACOParams& params, ThreadPool& pool);
 
+    // Dépôts cumulés dans l'ordre des fourmis : résultat indépendant des threads
     void update_pheromones(
-        std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash>& pheromones,
         const std::vector<Ant>& ants,
         const ACOParams& params
     );
 
     void apply_tour_to_ways(
-        const std::vector<osmium::object_id_type>& tour,
+        const Tour& tour,
         int group_id
     );
 
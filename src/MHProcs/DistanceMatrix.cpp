@@ -0,0 +1,221 @@
+#include "DistanceMatrix.hpp"
+#include "../Common/ThreadPool.hpp"
+#include <iostream>
+#include <algorithm>
+#include <queue>
+
+// Dijkstra mono-source depuis le POI source, arrêté dès que toutes les cibles sont fixées
+static void one_to_many_search(
+    const RoadGraph& rg,
+    SearchWorkspace& workspace,
+    uint32_t source,
+    const std::vector<uint32_t>& targets,
+    std::vector<float>& target_distances) {
+
+    workspace.prepare(rg.num_nodes());
+
+    // Marquage des cibles restantes (une même cible peut apparaître une seule fois)
+    std::vector<uint32_t> pending(targets.begin(), targets.end());
+    std::sort(pending.begin(), pending.end());
+    size_t remaining = pending.size();
+
+    using OpenEntry = std::pair<float, uint32_t>;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+    workspace.g_score[source] = 0.0f;
+    workspace.parent_node[source] = RoadGraph::INVALID_INDEX;
+    workspace.mark_seen(source);
+    open.emplace(0.0f, source);
+
+    while (!open.empty() && remaining > 0) {
+        const uint32_t u = open.top().second;
+        open.pop();
+
+        if (workspace.closed(u)) continue;
+        workspace.mark_closed(u);
+
+        if (std::binary_search(pending.begin(), pending.end(), u)) {
+            remaining--;
+        }
+
+        const float g = workspace.g_score[u];
+        for (uint32_t e = rg.edge_begin(u); e < rg.edge_end(u); ++e) {
+            const uint32_t v = rg.edge_target(e);
+            if (workspace.closed(v)) continue;
+
+            const float tentative = g + rg.edge_weight(e);
+            if (!workspace.seen(v) || tentative < workspace.g_score[v]) {
+                workspace.mark_seen(v);
+                workspace.g_score[v] = tentative;
+                workspace.parent_node[v] = u;
+                workspace.parent_edge[v] = e;
+                open.emplace(tentative, v);
+            }
+        }
+    }
+
+    target_distances.resize(targets.size());
+    for (size_t k = 0; k < targets.size(); ++k) {
+        target_distances[k] = workspace.closed(targets[k]) ? workspace.g_score[targets[k]] : -1.0f;
+    }
+}
+
+DistanceMatrix DistanceMatrix::build(
+    Pathfinder& pathfinder,
+    const std::vector<osmium::object_id_type>& objective_nodes,
+    int num_threads,
+    size_t max_tree_bytes) {
+
+    DistanceMatrix matrix;
+    matrix.pathfinder = &pathfinder;
+    matrix.graph = pathfinder.road_graph();
+    matrix.node_ids = objective_nodes;
+
+    // Un POI retiré par la contraction des chaînes impose l'instantané complet
+    if (matrix.graph->contracted() &&
+        std::any_of(objective_nodes.begin(), objective_nodes.end(), [&](osmium::object_id_type id) {
+            return matrix.graph->index_of(id) == RoadGraph::INVALID_INDEX;
+        })) {
+        matrix.graph = pathfinder.full_road_graph();
+    }
+
+    const RoadGraph& rg = *matrix.graph;
+    const size_t n = objective_nodes.size();
+
+    matrix.distances.assign(n * n, UNREACHABLE);
+    for (size_t i = 0; i < n; ++i) {
+        matrix.distances[i * n + i] = 0.0;
+        matrix.id_to_index.emplace(objective_nodes[i], i);
+    }
+
+    std::vector<uint32_t> indices(n);
+    for (size_t i = 0; i < n; ++i) {
+        indices[i] = rg.index_of(objective_nodes[i]);
+    }
+
+    // Arbres conservés seulement s'ils tiennent dans le budget mémoire
+    const size_t tree_bytes = (n > 0 ? n - 1 : 0) * size_t(rg.num_nodes()) * sizeof(uint32_t);
+    const bool keep_trees = tree_bytes <= max_tree_bytes;
+    if (keep_trees) {
+        matrix.parent_trees.resize(n);
+    } else {
+        std::cout << "Arbres de prédécesseurs non conservés (" << tree_bytes / (1024 * 1024)
+                  << " Mo > budget), chemins recalculés par A*" << std::endl;
+    }
+
+    // État de recherche propre à chaque worker ; chaque source i n'écrit que les cases
+    // (i, j) et (j, i) avec j > i et son propre arbre : aucune case partagée, pas de verrou
+    struct WorkerState {
+        SearchWorkspace workspace;
+        std::vector<uint32_t> targets;
+        std::vector<size_t> target_columns;
+        std::vector<float> target_distances;
+    };
+
+    ThreadPool pool(num_threads);
+    std::vector<WorkerState> states(pool.size());
+
+    // Graphe non orienté : la source i ne cherche que les POI j > i
+    pool.parallel_for(n > 0 ? n - 1 : 0, [&](size_t i, unsigned slot) {
+        if (indices[i] == RoadGraph::INVALID_INDEX) return;
+
+        WorkerState& state = states[slot];
+        state.targets.clear();
+        state.target_columns.clear();
+        for (size_t j = i + 1; j < n; ++j) {
+            if (indices[j] == RoadGraph::INVALID_INDEX) continue;
+            if (indices[j] == indices[i]) {
+                matrix.distances[i * n + j] = matrix.distances[j * n + i] = 0.0;
+                continue;
+            }
+            state.targets.push_back(indices[j]);
+            state.target_columns.push_back(j);
+        }
+        if (state.targets.empty()) return;
+
+        one_to_many_search(rg, state.workspace, indices[i], state.targets, state.target_distances);
+
+        for (size_t k = 0; k < state.targets.size(); ++k) {
+            if (state.target_distances[k] < 0.0f) continue;
+            const size_t j = state.target_columns[k];
+            matrix.distances[i * n + j] = state.target_distances[k];
+            matrix.distances[j * n + i] = state.target_distances[k];
+        }
+
+        if (keep_trees) {
+            auto& tree = matrix.parent_trees[i];
+            tree.assign(rg.num_nodes(), RoadGraph::INVALID_INDEX);
+            for (uint32_t u = 0; u < rg.num_nodes(); ++u) {
+                if (state.workspace.closed(u)) {
+                    tree[u] = state.workspace.parent_node[u];
+                }
+            }
+        }
+    });
+
+    return matrix;
+}
+
+size_t DistanceMatrix::index_of(osmium::object_id_type node_id) const {
+    auto it = id_to_index.find(node_id);
+    return (it != id_to_index.end()) ? it->second : node_ids.size();
+}
+
+double DistanceMatrix::tour_length(const Tour& tour) const {
+    if (tour.empty()) return 0.0;
+
+    double total_distance = 0.0;
+    for (size_t i = 0; i + 1 < tour.size(); ++i) {
+        total_distance += distance(tour[i], tour[i + 1]);
+    }
+    return total_distance + distance(tour.back(), tour.front());
+}
+
+std::vector<osmium::object_id_type> DistanceMatrix::path(size_t i, size_t j) const {
+    if (i == j || i >= size() || j >= size()) return {};
+
+    // Arbre disponible uniquement pour la plus petite des deux sources
+    const size_t source = std::min(i, j);
+    const size_t target = std::max(i, j);
+
+    if (source >= parent_trees.size() || parent_trees[source].empty()) {
+        return pathfinder ? pathfinder->A_Star_Search(node_ids[i], node_ids[j]) : std::vector<osmium::object_id_type>{};
+    }
+
+    const RoadGraph& rg = *graph;
+    const auto& tree = parent_trees[source];
+    const uint32_t source_index = rg.index_of(node_ids[source]);
+    uint32_t u = rg.index_of(node_ids[target]);
+
+    // Remontée target -> source ; l'arête retenue est la plus courte entre parent et enfant
+    std::vector<uint32_t> edge_path;
+    while (u != source_index) {
+        const uint32_t parent = tree[u];
+        if (parent == RoadGraph::INVALID_INDEX) return {};  // Inatteignable
+
+        uint32_t best_edge = RoadGraph::INVALID_INDEX;
+        for (uint32_t e = rg.edge_begin(parent); e < rg.edge_end(parent); ++e) {
+            if (rg.edge_target(e) == u &&
+                (best_edge == RoadGraph::INVALID_INDEX || rg.edge_weight(e) < rg.edge_weight(best_edge))) {
+                best_edge = e;
+            }
+        }
+        edge_path.push_back(best_edge);
+        u = parent;
+    }
+
+    // Ordre source -> target, ou target -> source (arêtes parcourues à l'envers) selon
+    // la demande ; les arêtes contractées se déplient en leurs ways d'origine
+    std::vector<osmium::object_id_type> way_path;
+    way_path.reserve(edge_path.size());
+    if (i == source) {
+        for (auto it = edge_path.rbegin(); it != edge_path.rend(); ++it) {
+            rg.append_edge_ways(*it, way_path);
+        }
+    } else {
+        for (uint32_t e : edge_path) {
+            rg.append_edge_ways(e, way_path, true);
+        }
+    }
+    return way_path;
+}
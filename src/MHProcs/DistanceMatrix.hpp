@@ -0,0 +1,61 @@
+#ifndef DISTANCE_MATRIX_HPP
+#define DISTANCE_MATRIX_HPP
+
+#include "../Box.hpp"
+#include "../RoadGraph.hpp"
+#include "../Pathfinding.hpp"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <limits>
+
+// Tour exprimé en indices 0..n-1 dans DistanceMatrix::nodes() : les solveurs
+// travaillent sur ces indices et ne convertissent en ids OSM qu'à l'application
+using Tour = std::vector<size_t>;
+
+// Matrice des distances routières entre les POI d'un groupe, partagée par les solveurs.
+// Construite avec une recherche Dijkstra mono-source par POI (arrêtée dès que tous les
+// POI suivants sont fixés) au lieu d'un A* par paire, les sources étant réparties sur
+// un pool de threads. Les arbres de prédécesseurs sont conservés pour reconstruire les
+// chemins sans relancer de recherche.
+class DistanceMatrix {
+public:
+    static constexpr double UNREACHABLE = std::numeric_limits<double>::max();
+
+    DistanceMatrix() = default;
+
+    // num_threads : nombre de workers (<= 0 : tous les cœurs) ;
+    // max_tree_bytes : budget mémoire des arbres de prédécesseurs ; au-delà les
+    // chemins sont recalculés à la demande par A*
+    static DistanceMatrix build(
+        Pathfinder& pathfinder,
+        const std::vector<osmium::object_id_type>& objective_nodes,
+        int num_threads = 0,
+        size_t max_tree_bytes = size_t(512) * 1024 * 1024
+    );
+
+    size_t size() const { return node_ids.size(); }
+    const std::vector<osmium::object_id_type>& nodes() const { return node_ids; }
+
+    // Indice du POI dans la matrice (size() si absent)
+    size_t index_of(osmium::object_id_type node_id) const;
+
+    double distance(size_t i, size_t j) const { return distances[i * node_ids.size() + j]; }
+
+    // Longueur du cycle (retour au point de départ inclus)
+    double tour_length(const Tour& tour) const;
+
+    // Ways du plus court chemin du POI i vers le POI j
+    std::vector<osmium::object_id_type> path(size_t i, size_t j) const;
+
+private:
+    std::vector<osmium::object_id_type> node_ids;
+    std::unordered_map<osmium::object_id_type, size_t> id_to_index;
+    std::vector<double> distances;  // Ligne majeure, n x n
+
+    Pathfinder* pathfinder = nullptr;
+    std::shared_ptr<const RoadGraph> graph;
+    std::vector<std::vector<uint32_t>> parent_trees;  // parent_trees[i][u] = prédécesseur de u depuis le POI i
+};
+
+#endif // DISTANCE_MATRIX_HPP
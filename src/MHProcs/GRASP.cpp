@@ -5,7 +5,7 @@
 #include <chrono>
 
 // Constructeur
-GRASPSolver::GRASPSolver(GeoBox& box) : geo_box(box) {
+GRASPSolver::GRASPSolver(GeoBox& box) : geo_box(box), pathfinder(box) {
     // Initialiser le générateur de nombres aléatoires avec l'horloge système
     rng.seed(std::chrono::steady_clock::now().time_since_epoch().count());
 }
@@ -26,7 +26,8 @@ bool GRASPSolver::solve_single_group(
 
     // 1. Construire le cache des distances
     std::cout << "Construction du cache des distances..." << std::endl;
-    build_distance_cache(objective_nodes);
+    build_distance_cache(objective_nodes, params.num_threads);
+    neighbor_lists = NeighborLists::build(distance_matrix, static_cast<size_t>(std::max(0, params.neighbor_list_size)));
 
     // 2. GRASP principal
     GRASPSolution best_solution;
@@ -35,7 +36,7 @@ bool GRASPSolver::solve_single_group(
     for (int iteration = 0; iteration < params.max_iterations; ++iteration) {
         
         // Phase de construction greedy randomisée
-        GRASPSolution current_solution = greedy_randomized_construction(objective_nodes, params);
+        GRASPSolution current_solution = greedy_randomized_construction(params);
         
         // Phase de recherche locale
         if (current_solution.is_valid) {
@@ -69,40 +70,43 @@ bool GRASPSolver::solve_single_group(
 }
 
 // Phase de construction greedy randomisée
-GRASPSolution GRASPSolver::greedy_randomized_construction(
-    const std::vector<osmium::object_id_type>& objective_nodes,
-    const GRASPParams& params) {
+GRASPSolution GRASPSolver::greedy_randomized_construction(const GRASPParams& params) {
 
     GRASPSolution solution;
+    const size_t n = distance_matrix.size();
     
     // Commencer par un POI aléatoire
-    std::uniform_int_distribution<int> dist(0, objective_nodes.size() - 1);
-    osmium::object_id_type current_node = objective_nodes[dist(rng)];
+    std::uniform_int_distribution<int> dist(0, n - 1);
+    size_t current_node = dist(rng);
     
+    solution.tour.reserve(n);
     solution.tour.push_back(current_node);
-    std::unordered_set<osmium::object_id_type> unvisited(objective_nodes.begin(), objective_nodes.end());
-    unvisited.erase(current_node);
+    std::vector<size_t> unvisited;
+    unvisited.reserve(n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (i != current_node) unvisited.push_back(i);
+    }
     
     // Construire le tour en utilisant la Liste Restreinte de Candidats (RCL)
     while (!unvisited.empty()) {
         
         // Construire la RCL
-        std::vector<osmium::object_id_type> rcl = build_restricted_candidate_list(
+        std::vector<size_t> rcl = build_restricted_candidate_list(
             current_node, unvisited, params.alpha);
         
         if (rcl.empty()) break;
         
         // Sélectionner aléatoirement dans la RCL
         std::uniform_int_distribution<int> rcl_dist(0, rcl.size() - 1);
-        osmium::object_id_type next_node = rcl[rcl_dist(rng)];
+        size_t next_node = rcl[rcl_dist(rng)];
         
         solution.tour.push_back(next_node);
-        unvisited.erase(next_node);
+        unvisited.erase(std::find(unvisited.begin(), unvisited.end(), next_node));
         current_node = next_node;
     }
     
     // Calculer la distance totale du tour (incluant le retour)
-    if (solution.tour.size() == objective_nodes.size()) {
+    if (solution.tour.size() == n) {
         solution.total_distance = calculate_tour_distance(solution.tour);
         solution.is_valid = true;
     }
@@ -147,59 +151,48 @@ GRASPSolution GRASPSolver::local_search(
     return current_solution;
 }
 
-// Amélioration 2-opt
+// Amélioration 2-opt (meilleur mouvement, gain évalué en O(1))
 GRASPSolution GRASPSolver::two_opt_improvement(const GRASPSolution& solution) {
     GRASPSolution best_solution = solution;
+    const size_t n = best_solution.tour.size();
+    if (n < 4) return best_solution;
     
-    for (size_t i = 1; i < solution.tour.size() - 2; ++i) {
-        for (size_t j = i + 1; j < solution.tour.size(); ++j) {
-            // Créer un nouveau tour en inversant le segment [i, j]
-            std::vector<osmium::object_id_type> new_tour = solution.tour;
-            std::reverse(new_tour.begin() + i, new_tour.begin() + j + 1);
-            
-            double new_distance = calculate_tour_distance(new_tour);
-            if (new_distance < best_solution.total_distance) {
-                best_solution.tour = new_tour;
-                best_solution.total_distance = new_distance;
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        // Descente complète restreinte aux voisins candidats
+        evaluator.improve_two_opt(best_solution.tour, best_solution.total_distance, neighbor_lists);
+        return best_solution;
     }
+    evaluator.best_two_opt(best_solution.tour, best_solution.total_distance, 1, n - 2, 1, n, false);
     
     return best_solution;
 }
 
-// Amélioration 3-opt (version simplifiée)
+// Amélioration 3-opt (version simplifiée : seule la reconnexion inversant [i+1, j] est testée ;
+// Or-opt par listes de candidats sur les grands groupes)
 GRASPSolution GRASPSolver::three_opt_improvement(const GRASPSolution& solution) {
     GRASPSolution best_solution = solution;
+    const size_t n = best_solution.tour.size();
+    if (n < 5) return best_solution;
     
-    for (size_t i = 0; i < solution.tour.size() - 3; ++i) {
-        for (size_t j = i + 2; j < solution.tour.size() - 1; ++j) {
-            for (size_t k = j + 2; k < solution.tour.size(); ++k) {
-                // Essayer différentes reconnexions 3-opt
-                std::vector<osmium::object_id_type> new_tour = solution.tour;
-                
-                // Version 1: inverser segment [i+1, j]
-                std::reverse(new_tour.begin() + i + 1, new_tour.begin() + j + 1);
-                
-                double new_distance = calculate_tour_distance(new_tour);
-                if (new_distance < best_solution.total_distance) {
-                    best_solution.tour = new_tour;
-                    best_solution.total_distance = new_distance;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_or_opt(best_solution.tour, best_solution.total_distance, neighbor_lists, 3);
+        return best_solution;
     }
+    evaluator.best_two_opt(best_solution.tour, best_solution.total_distance, 1, n - 2, 1, n - 2, false);
     
     return best_solution;
 }
 
 // Construction de la liste restreinte de candidats (RCL)
-std::vector<osmium::object_id_type> GRASPSolver::build_restricted_candidate_list(
-    osmium::object_id_type current_node,
-    const std::unordered_set<osmium::object_id_type>& unvisited,
+std::vector<size_t> GRASPSolver::build_restricted_candidate_list(
+    size_t current_node,
+    const std::vector<size_t>& unvisited,
     double alpha) {
 
-    std::vector<std::pair<osmium::object_id_type, double>> candidates;
+    std::vector<std::pair<size_t, double>> candidates;
+    candidates.reserve(unvisited.size());
     
     // Calculer les distances vers tous les nœuds non visités
     for (const auto& candidate : unvisited) {
@@ -219,7 +212,7 @@ std::vector<osmium::object_id_type> GRASPSolver::build_restricted_candidate_list
     double threshold = min_distance + alpha * (max_distance - min_distance);
     
     // Construire la RCL
-    std::vector<osmium::object_id_type> rcl;
+    std::vector<size_t> rcl;
     for (const auto& candidate : candidates) {
         if (candidate.second <= threshold) {
             rcl.push_back(candidate.first);
@@ -230,61 +223,29 @@ std::vector<osmium::object_id_type> GRASPSolver::build_restricted_candidate_list
 }
 
 // Méthodes utilitaires
-void GRASPSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes) {
-    distance_cache.clear();
-    
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        for (size_t j = i + 1; j < nodes.size(); ++j) {
-            osmium::object_id_type node1 = nodes[i];
-            osmium::object_id_type node2 = nodes[j];
-            
-            std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
-            
-            double distance = 0.0;
-            if (!path.empty()) {
-                for (const auto& way_id : path) {
-                    auto way_it = geo_box.data.ways.find(way_id);
-                    if (way_it != geo_box.data.ways.end()) {
-                        distance += way_it->second.distance_meters;
-                    }
-                }
-            } else {
-                distance = std::numeric_limits<double>::max();
-            }
-            
-            auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-            distance_cache[key] = distance;
-        }
-    }
+void GRASPSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads) {
+    // Une recherche un-vers-plusieurs par POI au lieu d'un A* par paire ;
+    // les tours sont ensuite exprimés en indices de cette matrice
+    distance_matrix = DistanceMatrix::build(pathfinder, nodes, num_threads);
 }
 
-double GRASPSolver::get_distance(osmium::object_id_type node1, osmium::object_id_type node2) {
-    auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-    auto it = distance_cache.find(key);
-    return (it != distance_cache.end()) ? it->second : std::numeric_limits<double>::max();
+double GRASPSolver::get_distance(size_t node1, size_t node2) const {
+    return distance_matrix.distance(node1, node2);
 }
 
-double GRASPSolver::calculate_tour_distance(const std::vector<osmium::object_id_type>& tour) {
-    double total_distance = 0.0;
-    
-    for (size_t i = 0; i < tour.size(); ++i) {
-        size_t next_i = (i + 1) % tour.size();
-        total_distance += get_distance(tour[i], tour[next_i]);
-    }
-    
-    return total_distance;
+double GRASPSolver::calculate_tour_distance(const Tour& tour) const {
+    return distance_matrix.tour_length(tour);
 }
 
 std::vector<osmium::object_id_type> GRASPSolver::find_shortest_path(
     osmium::object_id_type start, 
     osmium::object_id_type end) {
     
-    Pathfinder temp_pathfinder(geo_box);
-    return temp_pathfinder.A_Star_Search(start, end);
+    return pathfinder.A_Star_Search(start, end);
 }
 
 void GRASPSolver::apply_tour_to_ways(
-    const std::vector<osmium::object_id_type>& tour,
+    const Tour& tour,
     int group_id) {
 
     std::cout << "Application du tour GRASP aux ways du groupe " << group_id << "..." << std::endl;
@@ -292,10 +253,8 @@ void GRASPSolver::apply_tour_to_ways(
 
     for (size_t i = 0; i < tour.size(); ++i) {
         size_t next_i = (i + 1) % tour.size();
-        osmium::object_id_type node1 = tour[i];
-        osmium::object_id_type node2 = tour[next_i];
-
-        std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
+        // Chemin reconstruit depuis les arbres de prédécesseurs de la matrice
+        std::vector<osmium::object_id_type> path = distance_matrix.path(tour[i], tour[next_i]);
         
         for (const auto& way_id : path) {
             update_way_group(way_id, group_id);
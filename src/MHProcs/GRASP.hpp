@@ -2,16 +2,15 @@
 #define GRASP_HPP
 
 #include "../Box.hpp"
-#include "../Common/Hashes.hpp"
 #include "../Pathfinding.hpp"
+#include "DistanceMatrix.hpp"
+#include "MoveEvaluator.hpp"
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <random>
 
 // Structure pour stocker une solution GRASP
 struct GRASPSolution {
-    std::vector<osmium::object_id_type> tour;
+    Tour tour;  // Indices dans la matrice des distances
     double total_distance;
     bool is_valid;
     
@@ -31,6 +30,8 @@ struct GRASPParams {
     int local_search_iterations = 50; // Nombre d'itérations pour la recherche locale
     bool use_2opt = true;            // Utiliser l'amélioration 2-opt
     bool use_3opt = false;           // Utiliser l'amélioration 3-opt (plus coûteuse)
+    int num_threads = 0;             // Threads du calcul des distances (0 = tous les cœurs)
+    int neighbor_list_size = 0;      // Voisins candidats par POI (0 = voisinages complets)
     
     GRASPParams() = default;
 };
@@ -39,10 +40,14 @@ struct GRASPParams {
 class GRASPSolver {
 private:
     GeoBox& geo_box;
+    Pathfinder pathfinder;  // Réutilisé pour toutes les recherches (heuristique précalculée)
     std::mt19937 rng;
     
-    // Cache des distances pour éviter les recalculs
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash> distance_cache;
+    // Matrice des distances (Dijkstra un-vers-plusieurs) et arbres de chemins
+    DistanceMatrix distance_matrix;
+    
+    // Plus proches voisins de chaque POI pour la recherche locale (vides sur les petits groupes)
+    NeighborLists neighbor_lists;
 
 public:
     explicit GRASPSolver(GeoBox& box);
@@ -56,10 +61,7 @@ public:
 
 private:
     // Phase de construction
-    GRASPSolution greedy_randomized_construction(
-        const std::vector<osmium::object_id_type>& objective_nodes,
-        const GRASPParams& params
-    );
+    GRASPSolution greedy_randomized_construction(const GRASPParams& params);
     
     // Phase de recherche locale
     GRASPSolution local_search(
@@ -72,9 +74,9 @@ private:
     GRASPSolution three_opt_improvement(const GRASPSolution& solution);
     
     // Méthodes utilitaires
-    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes);
-    double get_distance(osmium::object_id_type node1, osmium::object_id_type node2);
-    double calculate_tour_distance(const std::vector<osmium::object_id_type>& tour);
+    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads);
+    double get_distance(size_t node1, size_t node2) const;
+    double calculate_tour_distance(const Tour& tour) const;
     
     std::vector<osmium::object_id_type> find_shortest_path(
         osmium::object_id_type start, 
@@ -82,16 +84,16 @@ private:
     );
     
     void apply_tour_to_ways(
-        const std::vector<osmium::object_id_type>& tour,
+        const Tour& tour,
         int group_id
     );
     
     void update_way_group(osmium::object_id_type way_id, int new_group);
     
     // Construction de la liste restreinte de candidats (RCL)
-    std::vector<osmium::object_id_type> build_restricted_candidate_list(
-        osmium::object_id_type current_node,
-        const std::unordered_set<osmium::object_id_type>& unvisited,
+    std::vector<size_t> build_restricted_candidate_list(
+        size_t current_node,
+        const std::vector<size_t>& unvisited,
         double alpha
     );
 };
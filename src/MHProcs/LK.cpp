@@ -0,0 +1,205 @@
+#include "LK.hpp"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <chrono>
+
+// Constructeur
+LKSolver::LKSolver(GeoBox& box) : geo_box(box), pathfinder(box) {
+    // Initialiser le générateur de nombres aléatoires
+    rng.seed(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+// Méthode principale LK pour un groupe
+bool LKSolver::solve_single_group(
+    const std::vector<osmium::object_id_type>& objective_nodes,
+    int group_id,
+    const LKParams& params) {
+
+    if (objective_nodes.size() < 2) {
+        std::cout << "LK Groupe " << group_id << ": Pas assez de POI (minimum 2)" << std::endl;
+        return false;
+    }
+
+    std::cout << "\n=== LK GROUPE " << group_id << " ===" << std::endl;
+    std::cout << "POI à optimiser: " << objective_nodes.size() << std::endl;
+
+    // 1. Construire le cache des distances
+    std::cout << "Construction du cache des distances..." << std::endl;
+    build_distance_cache(objective_nodes, params.num_threads);
+
+    // LK a besoin de listes même sur les petits groupes : au plus n - 2 voisins,
+    // tous les autres POI (à n - 2 près) si aucune taille n'est demandée
+    const size_t n = distance_matrix.size();
+    const size_t list_size = params.neighbor_list_size > 0
+        ? std::min(static_cast<size_t>(params.neighbor_list_size), n - 2)
+        : n - 2;
+    neighbor_lists = NeighborLists::build(distance_matrix, list_size);
+
+    // 2. Solution initiale (plus proche voisin) amenée à l'optimum local
+    LKSolution best_solution = nearest_neighbor_heuristic();
+    if (!best_solution.is_valid) {
+        std::cout << "LK: Impossible de générer une solution initiale" << std::endl;
+        return false;
+    }
+    std::cout << "Solution initiale: " << static_cast<int>(best_solution.total_distance) << "m" << std::endl;
+
+    local_optimum(best_solution, params);
+    std::cout << "Optimum local LK: " << static_cast<int>(best_solution.total_distance) << "m" << std::endl;
+
+    // 3. Recherche locale itérée : perturbation, réoptimisation locale, acceptation si meilleur
+    if (n >= 8 && !neighbor_lists.empty()) {
+        std::vector<size_t> seeds;
+        for (int iteration = 0; iteration < params.max_iterations; ++iteration) {
+            LKSolution candidate = double_bridge(best_solution, params, seeds);
+            local_optimum(candidate, params, seeds);
+
+            if (candidate.total_distance < best_solution.total_distance - MoveEvaluator::EPSILON) {
+                best_solution = std::move(candidate);
+            }
+
+            // Affichage du progrès
+            if (iteration % 200 == 0 || iteration == params.max_iterations - 1) {
+                std::cout << "Itération " << iteration << " - Meilleure distance: "
+                          << static_cast<int>(best_solution.total_distance) << "m" << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Solution LK trouvée - Distance totale: " << static_cast<int>(best_solution.total_distance) << "m" << std::endl;
+
+    // Appliquer le tour optimal aux ways
+    apply_tour_to_ways(best_solution.tour, group_id);
+
+    return true;
+}
+
+LKSolution LKSolver::nearest_neighbor_heuristic() {
+    LKSolution solution;
+    const size_t n = distance_matrix.size();
+    
+    if (n == 0) return solution;
+    
+    size_t current = 0;
+    solution.tour.reserve(n);
+    solution.tour.push_back(current);
+    
+    std::vector<char> visited(n, 0);
+    visited[current] = 1;
+    
+    while (solution.tour.size() < n) {
+        size_t nearest = n;
+        double min_distance = std::numeric_limits<double>::max();
+        
+        for (size_t candidate = 0; candidate < n; ++candidate) {
+            if (visited[candidate]) continue;
+            double distance = get_distance(current, candidate);
+            if (distance < min_distance) {
+                min_distance = distance;
+                nearest = candidate;
+            }
+        }
+        
+        if (nearest == n) break;
+        solution.tour.push_back(nearest);
+        visited[nearest] = 1;
+        current = nearest;
+    }
+    
+    if (solution.tour.size() == n) {
+        solution.total_distance = calculate_tour_distance(solution.tour);
+        solution.is_valid = true;
+    }
+    
+    return solution;
+}
+
+void LKSolver::local_optimum(LKSolution& solution, const LKParams& params, const std::vector<size_t>& seeds) {
+    MoveEvaluator evaluator(distance_matrix);
+    const size_t n = solution.tour.size();
+
+    // Très petits groupes : 2-opt complet
+    if (n < 5 || neighbor_lists.empty()) {
+        while (n >= 3 && evaluator.best_two_opt(solution.tour, solution.total_distance, 0, n - 1, 1, n, false)) {
+        }
+        return;
+    }
+
+    const size_t max_depth = static_cast<size_t>(std::max(1, params.max_depth));
+    const size_t breadth = static_cast<size_t>(std::max(1, params.breadth));
+    const size_t segment = static_cast<size_t>(std::max(1, params.or_opt_segment));
+
+    bool improved = true;
+    while (improved) {
+        improved = evaluator.improve_lin_kernighan(solution.tour, solution.total_distance, neighbor_lists,
+                                                   max_depth, breadth, seeds);
+        improved |= evaluator.improve_or_opt(solution.tour, solution.total_distance, neighbor_lists,
+                                             segment, seeds);
+    }
+}
+
+LKSolution LKSolver::double_bridge(const LKSolution& solution, const LKParams& params, std::vector<size_t>& seeds) {
+    const Tour& tour = solution.tour;
+    const size_t n = tour.size();
+
+    // Segments B et C courts et contigus : la perturbation reste locale
+    const size_t span = std::max<size_t>(1, std::min<size_t>(n / 4, static_cast<size_t>(std::max(1, params.max_perturbation_span))));
+    const size_t p1 = std::uniform_int_distribution<size_t>(1, n - 2 * span - 1)(rng);
+    const size_t p2 = p1 + std::uniform_int_distribution<size_t>(1, span)(rng);
+    const size_t p3 = p2 + std::uniform_int_distribution<size_t>(1, span)(rng);
+
+    LKSolution result;
+    result.tour.reserve(n);
+    result.tour.insert(result.tour.end(), tour.begin(), tour.begin() + p1);
+    result.tour.insert(result.tour.end(), tour.begin() + p2, tour.begin() + p3);
+    result.tour.insert(result.tour.end(), tour.begin() + p1, tour.begin() + p2);
+    result.tour.insert(result.tour.end(), tour.begin() + p3, tour.end());
+    result.total_distance = calculate_tour_distance(result.tour);
+    result.is_valid = true;
+
+    seeds.assign({tour[p1 - 1], tour[p1], tour[p2 - 1], tour[p2], tour[p3 - 1], tour[p3]});
+    return result;
+}
+
+// Méthodes utilitaires (similaires aux autres solveurs)
+void LKSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads) {
+    distance_matrix = DistanceMatrix::build(pathfinder, nodes, num_threads);
+}
+
+double LKSolver::get_distance(size_t node1, size_t node2) const {
+    return distance_matrix.distance(node1, node2);
+}
+
+double LKSolver::calculate_tour_distance(const Tour& tour) const {
+    return distance_matrix.tour_length(tour);
+}
+
+void LKSolver::apply_tour_to_ways(
+    const Tour& tour,
+    int group_id) {
+
+    std::cout << "Application du tour LK aux ways du groupe " << group_id << "..." << std::endl;
+    int ways_marked = 0;
+
+    for (size_t i = 0; i < tour.size(); ++i) {
+        size_t next_i = (i + 1) % tour.size();
+        // Chemin reconstruit depuis les arbres de prédécesseurs de la matrice
+        std::vector<osmium::object_id_type> path = distance_matrix.path(tour[i], tour[next_i]);
+        
+        for (const auto& way_id : path) {
+            update_way_group(way_id, group_id);
+            ways_marked++;
+        }
+    }
+
+    std::cout << "Ways marqués pour le groupe " << group_id << ": " << ways_marked << std::endl;
+}
+
+void LKSolver::update_way_group(osmium::object_id_type way_id, int new_group) {
+    auto it = geo_box.data.ways.find(way_id);
+    if (it != geo_box.data.ways.end()) {
+        it->second.add_group(new_group);
+    } else {
+        std::cerr << "Warning: Way " << way_id << " not found" << std::endl;
+    }
+}
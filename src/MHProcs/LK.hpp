@@ -0,0 +1,86 @@
+#ifndef LK_HPP
+#define LK_HPP
+
+#include "../Box.hpp"
+#include "../Pathfinding.hpp"
+#include "DistanceMatrix.hpp"
+#include "MoveEvaluator.hpp"
+#include <vector>
+#include <random>
+
+// Structure pour stocker une solution LK
+struct LKSolution {
+    Tour tour;  // Indices dans la matrice des distances
+    double total_distance;
+    bool is_valid;
+    
+    LKSolution() : total_distance(0.0), is_valid(false) {}
+    
+    void reset() {
+        tour.clear();
+        total_distance = 0.0;
+        is_valid = false;
+    }
+};
+
+// Paramètres de configuration LK
+struct LKParams {
+    int max_iterations = 1000;      // Perturbations double-bridge (recherche locale itérée)
+    int max_depth = 6;              // Inversions max par chaîne LK (k-opt séquentiel, k <= max_depth + 1)
+    int breadth = 5;                // Candidats essayés au premier niveau d'une chaîne
+    int or_opt_segment = 3;         // Longueur max des segments déplacés par Or-opt
+    int max_perturbation_span = 30; // Longueur max des segments échangés par le double-bridge
+    int neighbor_list_size = 0;     // Voisins candidats par POI (0 = tous les autres POI)
+    int num_threads = 0;            // Threads du calcul des distances (0 = tous les cœurs)
+    
+    LKParams() = default;
+};
+
+// Recherche locale itérée : Or-opt + Lin–Kernighan borné sur listes de candidats,
+// relancée par des perturbations double-bridge locales
+class LKSolver {
+private:
+    GeoBox& geo_box;
+    Pathfinder pathfinder;  // Réutilisé pour toutes les recherches (heuristique précalculée)
+    std::mt19937 rng;
+    
+    // Matrice des distances (Dijkstra un-vers-plusieurs) et arbres de chemins
+    DistanceMatrix distance_matrix;
+    
+    // Plus proches voisins de chaque POI pour la recherche locale
+    NeighborLists neighbor_lists;
+
+public:
+    explicit LKSolver(GeoBox& box);
+    
+    // Méthode principale LK pour un groupe
+    bool solve_single_group(
+        const std::vector<osmium::object_id_type>& objective_nodes,
+        int group_id,
+        const LKParams& params = LKParams{}
+    );
+
+private:
+    // Génération de solution initiale
+    LKSolution nearest_neighbor_heuristic();
+    
+    // Alternance LK / Or-opt jusqu'à l'optimum local (seeds : POI de départ, tous si vide)
+    void local_optimum(LKSolution& solution, const LKParams& params, const std::vector<size_t>& seeds = {});
+    
+    // Double-bridge A B C D -> A C B D ; seeds reçoit les extrémités des arêtes modifiées
+    LKSolution double_bridge(const LKSolution& solution, const LKParams& params, std::vector<size_t>& seeds);
+    
+    // Méthodes utilitaires
+    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads);
+    double get_distance(size_t node1, size_t node2) const;
+    double calculate_tour_distance(const Tour& tour) const;
+    
+    void apply_tour_to_ways(
+        const Tour& tour,
+        int group_id
+    );
+    
+    void update_way_group(osmium::object_id_type way_id, int new_group);
+};
+
+#endif // LK_HPP
@@ -0,0 +1,559 @@
+#include "MoveEvaluator.hpp"
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace {
+
+// File des POI à réexaminer : un POI hors de la file a son bit « don't look » levé.
+// Sans graines, tous les POI du tour sont actifs au départ.
+class ActiveQueue {
+public:
+    ActiveQueue(const Tour& tour, const std::vector<size_t>& seeds = {}) : queued(tour.size(), 0) {
+        for (size_t node : (seeds.empty() ? tour : seeds)) {
+            push(node);
+        }
+    }
+
+    bool pop(size_t& node) {
+        if (pending.empty()) return false;
+        node = pending.front();
+        pending.pop_front();
+        queued[node] = 0;
+        return true;
+    }
+
+    void push(size_t node) {
+        if (!queued[node]) {
+            queued[node] = 1;
+            pending.push_back(node);
+        }
+    }
+
+private:
+    std::deque<size_t> pending;
+    std::vector<char> queued;
+};
+
+// pos[node] = position du POI dans le tour
+void index_positions(const Tour& tour, std::vector<size_t>& pos) {
+    pos.resize(tour.size());
+    for (size_t k = 0; k < tour.size(); ++k) {
+        pos[tour[k]] = k;
+    }
+}
+
+// Inversion des positions [i, j] du cycle (modulo n). Le complément donne le même cycle
+// (distances symétriques) : le plus court des deux côtés est inversé.
+void reverse_cyclic(Tour& tour, std::vector<size_t>& pos, size_t i, size_t j) {
+    const size_t n = tour.size();
+    size_t length = (j + n - i) % n + 1;
+    if (2 * length > n) {
+        const size_t complement_begin = (j + 1) % n;
+        j = (i + n - 1) % n;
+        i = complement_begin;
+        length = n - length;
+    }
+
+    for (size_t k = 0; k < length / 2; ++k) {
+        std::swap(tour[i], tour[j]);
+        pos[tour[i]] = i;
+        pos[tour[j]] = j;
+        i = (i + 1) % n;
+        j = (j + n - 1) % n;
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// DELTAS
+// ============================================================================
+
+double MoveEvaluator::two_opt_delta(const Tour& tour, size_t i, size_t j) const {
+    const size_t n = tour.size();
+    if (i == 0 && j == n - 1) return 0.0;  // Tour entier inversé : même cycle
+
+    const size_t prev = tour[(i + n - 1) % n];
+    const size_t next = tour[(j + 1) % n];
+    return d(prev, tour[j]) + d(tour[i], next) - d(prev, tour[i]) - d(tour[j], next);
+}
+
+double MoveEvaluator::swap_delta(const Tour& tour, size_t i, size_t j) const {
+    const size_t n = tour.size();
+    if (n < 3 || i == j) return 0.0;
+
+    // Arêtes (p, p + 1) touchées, sans doublon quand i et j sont voisins
+    size_t edges[4] = {(i + n - 1) % n, i, (j + n - 1) % n, j};
+    size_t num_edges = 0;
+    for (size_t e : edges) {
+        if (std::find(edges, edges + num_edges, e) == edges + num_edges) {
+            edges[num_edges++] = e;
+        }
+    }
+
+    auto swapped = [&](size_t p) { return p == i ? tour[j] : (p == j ? tour[i] : tour[p]); };
+
+    double delta = 0.0;
+    for (size_t k = 0; k < num_edges; ++k) {
+        const size_t p = edges[k];
+        const size_t q = (p + 1) % n;
+        delta += d(swapped(p), swapped(q)) - d(tour[p], tour[q]);
+    }
+    return delta;
+}
+
+double MoveEvaluator::relocate_delta(const Tour& tour, size_t from, size_t to) const {
+    const size_t n = tour.size();
+    if (n < 2 || from == to) return 0.0;
+
+    const size_t node = tour[from];
+    const size_t prev = tour[(from + n - 1) % n];
+    const size_t next = tour[(from + 1) % n];
+
+    // Voisins d'insertion dans le tour réduit (sans le POI déplacé)
+    const size_t m = n - 1;
+    const size_t pos = (to > from) ? to - 1 : to;
+    auto reduced = [&](size_t k) { return tour[k < from ? k : k + 1]; };
+    const size_t u = reduced((pos + m - 1) % m);
+    const size_t v = reduced(pos % m);
+
+    return d(prev, next) - d(prev, node) - d(node, next)
+         + d(u, node) + d(node, v) - d(u, v);
+}
+
+double MoveEvaluator::or_opt_delta(const Tour& tour, size_t start, size_t length, size_t after, bool reversed) const {
+    const size_t n = tour.size();
+    const size_t first = tour[start];
+    const size_t last = tour[(start + length - 1) % n];
+    const size_t prev = tour[(start + n - 1) % n];
+    const size_t next = tour[(start + length) % n];
+    const size_t u = tour[after];
+    const size_t v = tour[(after + 1) % n];
+
+    const double removed = d(prev, first) + d(last, next) + d(u, v);
+    const double added = d(prev, next) + (reversed ? d(u, last) + d(first, v) : d(u, first) + d(last, v));
+    return added - removed;
+}
+
+// ============================================================================
+// APPLICATION
+// ============================================================================
+
+void MoveEvaluator::apply_two_opt(Tour& tour, size_t i, size_t j) {
+    std::reverse(tour.begin() + i, tour.begin() + j + 1);
+}
+
+void MoveEvaluator::apply_swap(Tour& tour, size_t i, size_t j) {
+    std::swap(tour[i], tour[j]);
+}
+
+void MoveEvaluator::apply_relocate(Tour& tour, size_t from, size_t to) {
+    const size_t node = tour[from];
+    tour.erase(tour.begin() + from);
+    tour.insert(tour.begin() + (to > from ? to - 1 : to), node);
+}
+
+void MoveEvaluator::apply_or_opt(Tour& tour, size_t start, size_t length, size_t after, bool reversed) {
+    const size_t anchor = tour[after];
+
+    // Segment à cheval sur la fin du vecteur : rotation pour le rendre contigu
+    if (start + length > tour.size()) {
+        std::rotate(tour.begin(), tour.begin() + start, tour.end());
+        start = 0;
+    }
+
+    Tour segment(tour.begin() + start, tour.begin() + start + length);
+    if (reversed) {
+        std::reverse(segment.begin(), segment.end());
+    }
+    tour.erase(tour.begin() + start, tour.begin() + start + length);
+
+    auto it = std::find(tour.begin(), tour.end(), anchor);
+    tour.insert(it + 1, segment.begin(), segment.end());
+}
+
+// ============================================================================
+// PARCOURS DE VOISINAGES
+// ============================================================================
+
+bool MoveEvaluator::best_two_opt(Tour& tour, double& total_distance,
+                                 size_t i_begin, size_t i_end, size_t min_span, size_t j_end,
+                                 bool first_improvement) const {
+    double best_delta = 0.0;
+    size_t best_i = 0, best_j = 0;
+    bool found = false;
+
+    for (size_t i = i_begin; i < i_end; ++i) {
+        for (size_t j = i + min_span; j < j_end; ++j) {
+            const double delta = two_opt_delta(tour, i, j);
+            if (delta < best_delta - EPSILON) {
+                best_delta = delta;
+                best_i = i;
+                best_j = j;
+                found = true;
+                if (first_improvement) break;
+            }
+        }
+        if (found && first_improvement) break;
+    }
+
+    if (found) {
+        apply_two_opt(tour, best_i, best_j);
+        total_distance = matrix->tour_length(tour);
+    }
+    return found;
+}
+
+bool MoveEvaluator::best_swap(Tour& tour, double& total_distance, bool first_improvement) const {
+    double best_delta = 0.0;
+    size_t best_i = 0, best_j = 0;
+    bool found = false;
+
+    for (size_t i = 0; i < tour.size(); ++i) {
+        for (size_t j = i + 1; j < tour.size(); ++j) {
+            const double delta = swap_delta(tour, i, j);
+            if (delta < best_delta - EPSILON) {
+                best_delta = delta;
+                best_i = i;
+                best_j = j;
+                found = true;
+                if (first_improvement) break;
+            }
+        }
+        if (found && first_improvement) break;
+    }
+
+    if (found) {
+        apply_swap(tour, best_i, best_j);
+        total_distance = matrix->tour_length(tour);
+    }
+    return found;
+}
+
+bool MoveEvaluator::best_relocate(Tour& tour, double& total_distance, bool first_improvement) const {
+    double best_delta = 0.0;
+    size_t best_from = 0, best_to = 0;
+    bool found = false;
+
+    for (size_t from = 0; from < tour.size(); ++from) {
+        for (size_t to = 0; to < tour.size(); ++to) {
+            if (from == to) continue;
+
+            const double delta = relocate_delta(tour, from, to);
+            if (delta < best_delta - EPSILON) {
+                best_delta = delta;
+                best_from = from;
+                best_to = to;
+                found = true;
+                if (first_improvement) break;
+            }
+        }
+        if (found && first_improvement) break;
+    }
+
+    if (found) {
+        apply_relocate(tour, best_from, best_to);
+        total_distance = matrix->tour_length(tour);
+    }
+    return found;
+}
+
+// ============================================================================
+// DESCENTES PAR LISTES DE CANDIDATS
+// ============================================================================
+
+bool MoveEvaluator::improve_two_opt(Tour& tour, double& total_distance, const NeighborLists& neighbors) const {
+    const size_t n = tour.size();
+    if (n < 4) return false;
+
+    std::vector<size_t> pos;
+    index_positions(tour, pos);
+    auto succ = [&](size_t node) { return tour[(pos[node] + 1) % n]; };
+    auto pred = [&](size_t node) { return tour[(pos[node] + n - 1) % n]; };
+
+    ActiveQueue active(tour);
+    bool improved = false;
+    size_t a;
+
+    while (active.pop(a)) {
+        bool moved = false;
+
+        // Arête (a, b) retirée, b successeur puis prédécesseur de a
+        for (int direction = 0; direction < 2 && !moved; ++direction) {
+            const bool forward = (direction == 0);
+            const size_t b = forward ? succ(a) : pred(a);
+            const double d_ab = d(a, b);
+
+            for (size_t c : neighbors.of(a)) {
+                const double d_ac = d(a, c);
+                if (d_ac >= d_ab - EPSILON) break;  // Voisins triés : plus aucun gain possible
+
+                const size_t e = forward ? succ(c) : pred(c);
+                if (c == b || e == a) continue;
+
+                const double delta = d_ac + d(b, e) - d_ab - d(c, e);
+                if (delta < -EPSILON) {
+                    // a b ... c e -> a c ... b e (et symétriquement vers l'arrière)
+                    if (forward) {
+                        reverse_cyclic(tour, pos, pos[b], pos[c]);
+                    } else {
+                        reverse_cyclic(tour, pos, pos[a], pos[e]);
+                    }
+                    total_distance += delta;
+                    for (size_t node : {a, b, c, e}) active.push(node);
+                    moved = improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (improved) {
+        total_distance = matrix->tour_length(tour);
+    }
+    return improved;
+}
+
+bool MoveEvaluator::improve_or_opt(Tour& tour, double& total_distance, const NeighborLists& neighbors,
+                                   size_t max_segment, const std::vector<size_t>& seeds) const {
+    const size_t n = tour.size();
+    if (n < 5) return false;
+
+    std::vector<size_t> pos;
+    index_positions(tour, pos);
+    auto succ = [&](size_t node) { return tour[(pos[node] + 1) % n]; };
+    auto pred = [&](size_t node) { return tour[(pos[node] + n - 1) % n]; };
+
+    ActiveQueue active(tour, seeds);
+    bool improved = false;
+    size_t a;
+
+    while (active.pop(a)) {
+        bool moved = false;
+
+        // Segment de length POI commençant en a
+        for (size_t length = 1; length <= max_segment && length + 3 <= n && !moved; ++length) {
+            const size_t start = pos[a];
+            const size_t first = a;
+            const size_t last = tour[(start + length - 1) % n];
+            const size_t prev = pred(first);
+            const size_t next = succ(last);
+
+            const double removal_gain = d(prev, first) + d(last, next) - d(prev, next);
+            if (removal_gain <= EPSILON) continue;
+
+            auto in_segment = [&](size_t node) { return (pos[node] + n - start) % n < length; };
+
+            // L'extrémité end du segment est reliée à un voisin candidat c
+            for (int side = 0; side < (length == 1 ? 1 : 2) && !moved; ++side) {
+                const size_t end = (side == 0) ? first : last;
+
+                for (size_t c : neighbors.of(end)) {
+                    if (d(end, c) >= removal_gain - EPSILON) break;
+                    if (in_segment(c)) continue;
+
+                    // Insertion entre c et son successeur, puis entre son prédécesseur et c
+                    for (int slot = 0; slot < 2 && !moved; ++slot) {
+                        const bool after_c = (slot == 0);
+                        if (after_c ? c == prev : c == next) continue;
+
+                        const size_t after = after_c ? pos[c] : pos[pred(c)];
+                        const bool reversed = (end == first) != after_c;
+
+                        const double delta = or_opt_delta(tour, start, length, after, reversed);
+                        if (delta < -EPSILON) {
+                            const size_t u = tour[after];
+                            const size_t v = tour[(after + 1) % n];
+                            apply_or_opt(tour, start, length, after, reversed);
+                            index_positions(tour, pos);
+                            total_distance += delta;
+                            for (size_t node : {prev, next, first, last, u, v}) active.push(node);
+                            moved = improved = true;
+                        }
+                    }
+                    if (moved) break;
+                }
+            }
+        }
+    }
+
+    if (improved) {
+        total_distance = matrix->tour_length(tour);
+    }
+    return improved;
+}
+
+bool MoveEvaluator::improve_swap(Tour& tour, double& total_distance, const NeighborLists& neighbors) const {
+    const size_t n = tour.size();
+    if (n < 4) return false;
+
+    std::vector<size_t> pos;
+    index_positions(tour, pos);
+    auto succ = [&](size_t node) { return tour[(pos[node] + 1) % n]; };
+    auto pred = [&](size_t node) { return tour[(pos[node] + n - 1) % n]; };
+
+    ActiveQueue active(tour);
+    bool improved = false;
+    size_t a;
+
+    while (active.pop(a)) {
+        // Le mouvement doit remplacer au moins la plus longue arête de a par une plus courte
+        const double longest_edge = std::max(d(pred(a), a), d(a, succ(a)));
+        bool moved = false;
+
+        for (size_t c : neighbors.of(a)) {
+            if (d(a, c) >= longest_edge - EPSILON) break;
+
+            // a prend la place d'un voisin de c dans le tour
+            for (size_t x : {pred(c), succ(c)}) {
+                if (x == a) continue;
+
+                const size_t i = pos[a];
+                const size_t j = pos[x];
+                const double delta = swap_delta(tour, i, j);
+                if (delta < -EPSILON) {
+                    apply_swap(tour, i, j);
+                    pos[tour[i]] = i;
+                    pos[tour[j]] = j;
+                    total_distance += delta;
+                    for (size_t k : {i, j}) {
+                        active.push(tour[(k + n - 1) % n]);
+                        active.push(tour[k]);
+                        active.push(tour[(k + 1) % n]);
+                    }
+                    moved = improved = true;
+                    break;
+                }
+            }
+            if (moved) break;
+        }
+    }
+
+    if (improved) {
+        total_distance = matrix->tour_length(tour);
+    }
+    return improved;
+}
+
+bool MoveEvaluator::improve_lin_kernighan(Tour& tour, double& total_distance, const NeighborLists& neighbors,
+                                          size_t max_depth, size_t breadth, const std::vector<size_t>& seeds) const {
+    const size_t n = tour.size();
+    if (n < 5 || max_depth == 0 || breadth == 0) return false;
+
+    std::vector<size_t> pos;
+    index_positions(tour, pos);
+    auto succ = [&](size_t node) { return tour[(pos[node] + 1) % n]; };
+    auto pred = [&](size_t node) { return tour[(pos[node] + n - 1) % n]; };
+
+    // Sens de parcours courant : la chaîne garde t2 = next(t1)
+    bool forward = true;
+    auto next = [&](size_t node) { return forward ? succ(node) : pred(node); };
+    auto prev = [&](size_t node) { return forward ? pred(node) : succ(node); };
+
+    struct Flip { size_t i, j; };
+    std::vector<Flip> flips;
+    std::vector<std::pair<size_t, size_t>> added;
+    std::vector<size_t> touched;
+    std::vector<std::pair<double, size_t>> first_level;
+
+    auto is_added = [&](size_t u, size_t v) {
+        return std::any_of(added.begin(), added.end(), [&](const auto& edge) {
+            return (edge.first == u && edge.second == v) || (edge.first == v && edge.second == u);
+        });
+    };
+
+    ActiveQueue active(tour, seeds);
+    bool improved = false;
+    size_t t1;
+
+    while (active.pop(t1)) {
+        bool moved = false;
+
+        for (int direction = 0; direction < 2 && !moved; ++direction) {
+            forward = (direction == 0);
+            const size_t t2_start = next(t1);
+            const double g_start = d(t1, t2_start);
+
+            // Premier niveau : candidats classés par d(t3, t4) - d(t2, t3), seuls les
+            // breadth meilleurs sont essayés (retour arrière), les niveaux suivants sont gloutons
+            first_level.clear();
+            for (size_t c : neighbors.of(t2_start)) {
+                if (d(t2_start, c) >= g_start - EPSILON) break;
+                if (c == t1 || c == next(t2_start)) continue;
+                first_level.emplace_back(d(c, prev(c)) - d(t2_start, c), c);
+            }
+            std::sort(first_level.begin(), first_level.end(),
+                [](const auto& a, const auto& b) { return a.first > b.first; });
+            if (first_level.size() > breadth) first_level.resize(breadth);
+
+            for (const auto& [score, first_t3] : first_level) {
+                forward = (direction == 0);
+                size_t t2 = t2_start;
+                double gain = g_start;
+                double best_gain = 0.0;
+                size_t best_depth = 0;
+                flips.clear();
+                added.clear();
+                touched.assign({t1, t2});
+
+                for (size_t depth = 1; depth <= max_depth; ++depth) {
+                    size_t t3 = first_t3;
+                    if (depth > 1) {
+                        // Meilleur t3 parmi les voisins de t2 gardant un gain partiel positif
+                        double best_score = -std::numeric_limits<double>::max();
+                        t3 = n;
+                        for (size_t c : neighbors.of(t2)) {
+                            if (d(t2, c) >= gain - EPSILON) break;
+                            if (c == t1 || c == next(t2) || is_added(c, prev(c))) continue;
+                            const double candidate_score = d(c, prev(c)) - d(t2, c);
+                            if (candidate_score > best_score) {
+                                best_score = candidate_score;
+                                t3 = c;
+                            }
+                        }
+                        if (t3 == n) break;
+                    }
+
+                    // t1 t2 ... t4 t3 -> t1 t4 ... t2 t3 : retire (t4, t3), ajoute (t2, t3)
+                    const size_t t4 = prev(t3);
+                    const Flip flip = forward ? Flip{pos[t2], pos[t4]} : Flip{pos[t4], pos[t2]};
+                    reverse_cyclic(tour, pos, flip.i, flip.j);
+                    flips.push_back(flip);
+                    added.emplace_back(t2, t3);
+                    touched.push_back(t3);
+                    touched.push_back(t4);
+
+                    gain += d(t3, t4) - d(t2, t3);
+                    forward = (succ(t1) == t4);
+                    t2 = t4;
+
+                    // Le tour courant est fermé par l'arête (t4, t1)
+                    const double closed_gain = gain - d(t2, t1);
+                    if (closed_gain > best_gain + EPSILON) {
+                        best_gain = closed_gain;
+                        best_depth = flips.size();
+                    }
+                }
+
+                // Annulation des inversions au-delà de la meilleure profondeur
+                while (flips.size() > best_depth) {
+                    reverse_cyclic(tour, pos, flips.back().i, flips.back().j);
+                    flips.pop_back();
+                }
+
+                if (best_depth > 0) {
+                    total_distance -= best_gain;
+                    for (size_t k = 0; k < 2 + 2 * best_depth; ++k) active.push(touched[k]);
+                    moved = improved = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (improved) {
+        total_distance = matrix->tour_length(tour);
+    }
+    return improved;
+}
@@ -0,0 +1,84 @@
+#ifndef MOVE_EVALUATOR_HPP
+#define MOVE_EVALUATOR_HPP
+
+#include "DistanceMatrix.hpp"
+#include "NeighborLists.hpp"
+#include <vector>
+
+// Évaluation en O(1) du gain des mouvements de recherche locale sur un tour fermé
+// (indices de la DistanceMatrix). Seules les arêtes touchées par le mouvement sont
+// relues ; le nouveau tour n'est construit que si le mouvement est accepté.
+// Un delta négatif signifie que le tour raccourcit.
+class MoveEvaluator {
+public:
+    // Gain minimal pour accepter un mouvement (évite de boucler sur du bruit flottant)
+    static constexpr double EPSILON = 1e-7;
+
+    MoveEvaluator() = default;
+    explicit MoveEvaluator(const DistanceMatrix& matrix) : matrix(&matrix) {}
+
+    // Inversion du segment [i, j] (i < j)
+    double two_opt_delta(const Tour& tour, size_t i, size_t j) const;
+
+    // Échange des POI aux positions i et j
+    double swap_delta(const Tour& tour, size_t i, size_t j) const;
+
+    // Le POI en position from est retiré puis réinséré à la position
+    // (to > from ? to - 1 : to) du tour réduit
+    double relocate_delta(const Tour& tour, size_t from, size_t to) const;
+
+    // Or-opt : le segment [start, start + length) (indices modulo n) est déplacé entre
+    // les positions after et after + 1 (hors du segment), éventuellement inversé
+    double or_opt_delta(const Tour& tour, size_t start, size_t length, size_t after, bool reversed) const;
+
+    static void apply_two_opt(Tour& tour, size_t i, size_t j);
+    static void apply_swap(Tour& tour, size_t i, size_t j);
+    static void apply_relocate(Tour& tour, size_t from, size_t to);
+    static void apply_or_opt(Tour& tour, size_t start, size_t length, size_t after, bool reversed);
+
+    // Parcours de voisinages dans l'ordre des anciennes boucles (mêmes tours acceptés) :
+    // le meilleur mouvement (ou le premier si first_improvement) est appliqué au tour
+    // et total_distance recalculée. Renvoie true si le tour a été amélioré.
+
+    // Inversions [i, j] pour i dans [i_begin, i_end) et j dans [i + min_span, j_end)
+    bool best_two_opt(Tour& tour, double& total_distance,
+                      size_t i_begin, size_t i_end, size_t min_span, size_t j_end,
+                      bool first_improvement) const;
+
+    // Échanges (i, j), i < j
+    bool best_swap(Tour& tour, double& total_distance, bool first_improvement) const;
+
+    // Déplacements (from, to), from != to
+    bool best_relocate(Tour& tour, double& total_distance, bool first_improvement) const;
+
+    // Descentes jusqu'à l'optimum local restreintes aux listes de candidats, avec bits
+    // « don't look » : seuls les POI dont une arête a changé sont réexaminés.
+    // Renvoient true si le tour a été amélioré.
+
+    // 2-opt : chaque mouvement crée une arête (a, c) avec c voisin candidat de a
+    bool improve_two_opt(Tour& tour, double& total_distance, const NeighborLists& neighbors) const;
+
+    // Les descentes acceptant seeds ne partent que de ces POI (tous si vide), par exemple
+    // les extrémités des arêtes modifiées par une perturbation.
+
+    // Or-opt : segments de 1 à max_segment POI réinsérés (dans un sens ou l'autre)
+    // à côté d'un voisin candidat d'une de leurs extrémités ; max_segment = 1 : relocate
+    bool improve_or_opt(Tour& tour, double& total_distance, const NeighborLists& neighbors,
+                        size_t max_segment, const std::vector<size_t>& seeds = {}) const;
+
+    // Échanges plaçant a à côté d'un de ses voisins candidats
+    bool improve_swap(Tour& tour, double& total_distance, const NeighborLists& neighbors) const;
+
+    // Lin–Kernighan borné : chaîne d'au plus max_depth inversions 2-opt séquentielles
+    // (mouvement k-opt, k <= max_depth + 1) arrêtée à la profondeur de meilleur gain.
+    // Les breadth meilleurs candidats du premier niveau sont essayés, les suivants gloutons.
+    bool improve_lin_kernighan(Tour& tour, double& total_distance, const NeighborLists& neighbors,
+                               size_t max_depth, size_t breadth, const std::vector<size_t>& seeds = {}) const;
+
+private:
+    const DistanceMatrix* matrix = nullptr;
+
+    double d(size_t a, size_t b) const { return matrix->distance(a, b); }
+};
+
+#endif // MOVE_EVALUATOR_HPP
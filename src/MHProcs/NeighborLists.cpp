@@ -0,0 +1,37 @@
+#include "NeighborLists.hpp"
+#include <algorithm>
+
+NeighborLists NeighborLists::build(const DistanceMatrix& matrix, size_t k) {
+    NeighborLists lists;
+    const size_t n = matrix.size();
+    if (k == 0 || n < 2 || k >= n - 1) return lists;
+
+    lists.stride = k;
+    lists.neighbors.assign(n * k, 0);
+    lists.counts.assign(n, 0);
+
+    std::vector<size_t> candidates;
+    candidates.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        candidates.clear();
+        for (size_t j = 0; j < n; ++j) {
+            if (j != i && matrix.distance(i, j) != DistanceMatrix::UNREACHABLE) {
+                candidates.push_back(j);
+            }
+        }
+
+        const size_t count = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+            [&](size_t a, size_t b) {
+                const double da = matrix.distance(i, a);
+                const double db = matrix.distance(i, b);
+                return da < db || (da == db && a < b);
+            });
+
+        std::copy(candidates.begin(), candidates.begin() + count, lists.neighbors.begin() + i * k);
+        lists.counts[i] = count;
+    }
+
+    return lists;
+}
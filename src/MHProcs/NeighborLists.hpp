@@ -0,0 +1,32 @@
+#ifndef NEIGHBOR_LISTS_HPP
+#define NEIGHBOR_LISTS_HPP
+
+#include "DistanceMatrix.hpp"
+#include <vector>
+#include <span>
+
+// Listes de candidats : pour chaque POI, ses k plus proches voisins atteignables triés
+// par distance croissante. La recherche locale ne teste que les mouvements créant une
+// arête vers l'un de ces voisins (O(n·k) par passe au lieu de O(n²)).
+class NeighborLists {
+public:
+    NeighborLists() = default;
+
+    // Listes vides si k == 0 ou si elles couvriraient tous les POI (k >= n - 1) :
+    // les solveurs gardent alors leurs voisinages complets
+    static NeighborLists build(const DistanceMatrix& matrix, size_t k);
+
+    bool empty() const { return stride == 0; }
+    size_t size() const { return counts.size(); }
+
+    std::span<const size_t> of(size_t i) const {
+        return {neighbors.data() + i * stride, counts[i]};
+    }
+
+private:
+    size_t stride = 0;
+    std::vector<size_t> neighbors;  // n x stride, seules les counts[i] premières cases sont valides
+    std::vector<size_t> counts;
+};
+
+#endif // NEIGHBOR_LISTS_HPP
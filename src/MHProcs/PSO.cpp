@@ -3,9 +3,10 @@
 #include <algorithm>
 #include <limits>
 #include <chrono>
+#include <numeric>
 
 // Constructeur
-PSOSolver::PSOSolver(GeoBox& box) : geo_box(box), global_best_fitness(std::numeric_limits<double>::max()) {
+PSOSolver::PSOSolver(GeoBox& box) : geo_box(box), pathfinder(box), global_best_fitness(std::numeric_limits<double>::max()) {
     // Initialiser le générateur de nombres aléatoires
     rng.seed(std::chrono::steady_clock::now().time_since_epoch().count());
 }
@@ -26,11 +27,12 @@ bool PSOSolver::solve_single_group(
 
     // 1. Construire le cache des distances
     std::cout << "Construction du cache des distances..." << std::endl;
-    build_distance_cache(objective_nodes);
+    build_distance_cache(objective_nodes, params.num_threads);
+    neighbor_lists = NeighborLists::build(distance_matrix, static_cast<size_t>(std::max(0, params.neighbor_list_size)));
 
     // 2. Initialiser l'essaim
     std::cout << "Initialisation de l'essaim (" << params.num_particles << " particules)..." << std::endl;
-    initialize_swarm(objective_nodes, params);
+    initialize_swarm(params);
 
     // 3. Algorithme PSO principal
     for (int iteration = 0; iteration < params.max_iterations; ++iteration) {
@@ -42,7 +44,7 @@ bool PSOSolver::solve_single_group(
             update_particle_velocity(particle, params);
             
             // Mettre à jour la position
-            update_particle_position(particle, objective_nodes);
+            update_particle_position(particle);
             
             // Évaluer la nouvelle position
             particle.fitness = evaluate_fitness(particle.position);
@@ -62,7 +64,7 @@ bool PSOSolver::solve_single_group(
         
         // Recherche locale sur la meilleure particule (optionnel)
         if (params.use_local_search && iteration % 10 == 0) {
-            std::vector<osmium::object_id_type> improved = local_search_2opt(global_best_position);
+            Tour improved = local_search_2opt(global_best_position);
             double improved_fitness = evaluate_fitness(improved);
             if (improved_fitness < global_best_fitness) {
                 global_best_fitness = improved_fitness;
@@ -88,7 +90,7 @@ bool PSOSolver::solve_single_group(
     }
 
     // 4. Vérifier et appliquer la solution
-    if (global_best_position.empty() || !is_valid_tour(global_best_position, objective_nodes)) {
+    if (global_best_position.empty() || !is_valid_tour(global_best_position)) {
         std::cout << "PSO Groupe " << group_id << ": Aucune solution valide trouvée" << std::endl;
         return false;
     }
@@ -102,9 +104,7 @@ bool PSOSolver::solve_single_group(
 }
 
 // Initialisation de l'essaim
-void PSOSolver::initialize_swarm(
-    const std::vector<osmium::object_id_type>& nodes,
-    const PSOParams& params) {
+void PSOSolver::initialize_swarm(const PSOParams& params) {
 
     swarm.clear();
     swarm.resize(params.num_particles);
@@ -117,14 +117,14 @@ void PSOSolver::initialize_swarm(
         // Générer une position initiale
         if (i == 0) {
             // Première particule: heuristique du plus proche voisin
-            particle.position = nearest_neighbor_tour(nodes, nodes[0]);
+            particle.position = nearest_neighbor_tour(0);
         } else if (i < params.num_particles / 2) {
             // Moitié des particules: plus proche voisin avec départ différent
-            std::uniform_int_distribution<int> dist(0, nodes.size() - 1);
-            particle.position = nearest_neighbor_tour(nodes, nodes[dist(rng)]);
+            std::uniform_int_distribution<int> dist(0, distance_matrix.size() - 1);
+            particle.position = nearest_neighbor_tour(dist(rng));
         } else {
             // Autre moitié: complètement aléatoire
-            particle.position = generate_random_tour(nodes);
+            particle.position = generate_random_tour();
         }
         
         // Évaluer la position initiale
@@ -144,30 +144,29 @@ void PSOSolver::initialize_swarm(
 }
 
 // Génération de tours initiaux
-std::vector<osmium::object_id_type> PSOSolver::generate_random_tour(
-    const std::vector<osmium::object_id_type>& nodes) {
-    
-    std::vector<osmium::object_id_type> tour = nodes;
+Tour PSOSolver::generate_random_tour() {
+    Tour tour(distance_matrix.size());
+    std::iota(tour.begin(), tour.end(), size_t(0));
     std::shuffle(tour.begin(), tour.end(), rng);
     return tour;
 }
 
-std::vector<osmium::object_id_type> PSOSolver::nearest_neighbor_tour(
-    const std::vector<osmium::object_id_type>& nodes,
-    osmium::object_id_type start_node) {
+Tour PSOSolver::nearest_neighbor_tour(size_t start_node) {
+    const size_t n = distance_matrix.size();
+    Tour tour;
+    tour.reserve(n);
+    std::vector<char> visited(n, 0);
     
-    std::vector<osmium::object_id_type> tour;
-    std::unordered_set<osmium::object_id_type> unvisited(nodes.begin(), nodes.end());
-    
-    osmium::object_id_type current = start_node;
+    size_t current = start_node;
     tour.push_back(current);
-    unvisited.erase(current);
+    visited[current] = 1;
     
-    while (!unvisited.empty()) {
-        osmium::object_id_type nearest = 0;
+    while (tour.size() < n) {
+        size_t nearest = n;
         double min_distance = std::numeric_limits<double>::max();
         
-        for (const auto& candidate : unvisited) {
+        for (size_t candidate = 0; candidate < n; ++candidate) {
+            if (visited[candidate]) continue;
             double distance = get_distance(current, candidate);
             if (distance < min_distance) {
                 min_distance = distance;
@@ -175,9 +174,9 @@ std::vector<osmium::object_id_type> PSOSolver::nearest_neighbor_tour(
             }
         }
         
-        if (nearest != 0) {
+        if (nearest != n) {
             tour.push_back(nearest);
-            unvisited.erase(nearest);
+            visited[nearest] = 1;
             current = nearest;
         } else {
             break;
@@ -193,10 +192,10 @@ void PSOSolver::update_particle_velocity(
     const PSOParams& params) {
 
     // Calculer les séquences de swaps vers le meilleur personnel et global
-    std::vector<osmium::object_id_type> cognitive_component = 
+    std::vector<size_t> cognitive_component = 
         compute_swap_sequence(particle.position, particle.best_position);
     
-    std::vector<osmium::object_id_type> social_component = 
+    std::vector<size_t> social_component = 
         compute_swap_sequence(particle.position, global_best_position);
     
     // Générer des coefficients aléatoires
@@ -223,26 +222,24 @@ void PSOSolver::update_particle_velocity(
 }
 
 // Mise à jour de la position des particules
-void PSOSolver::update_particle_position(
-    Particle& particle,
-    const std::vector<osmium::object_id_type>& nodes) {
+void PSOSolver::update_particle_position(Particle& particle) {
     
     // Appliquer la vitesse à la position
     particle.position = apply_swap_sequence(particle.position, particle.velocity);
     
     // Vérifier la validité du tour et corriger si nécessaire
-    if (!is_valid_tour(particle.position, nodes)) {
+    if (!is_valid_tour(particle.position)) {
         // Si le tour n'est pas valide, générer un nouveau tour aléatoire
-        particle.position = generate_random_tour(nodes);
+        particle.position = generate_random_tour();
     }
 }
 
 // Opérateurs PSO adaptés au TSP
-std::vector<osmium::object_id_type> PSOSolver::apply_swap_sequence(
-    const std::vector<osmium::object_id_type>& tour,
-    const std::vector<osmium::object_id_type>& swaps) {
+Tour PSOSolver::apply_swap_sequence(
+    const Tour& tour,
+    const std::vector<size_t>& swaps) {
     
-    std::vector<osmium::object_id_type> result = tour;
+    Tour result = tour;
     
     // Appliquer une partie aléatoire des swaps (pour l'aspect stochastique)
     int num_swaps = std::min(static_cast<int>(swaps.size()), static_cast<int>(tour.size() / 2));
@@ -262,15 +259,15 @@ std::vector<osmium::object_id_type> PSOSolver::apply_swap_sequence(
     return result;
 }
 
-std::vector<osmium::object_id_type> PSOSolver::compute_swap_sequence(
-    const std::vector<osmium::object_id_type>& from_tour,
-    const std::vector<osmium::object_id_type>& to_tour) {
+std::vector<size_t> PSOSolver::compute_swap_sequence(
+    const Tour& from_tour,
+    const Tour& to_tour) {
     
-    std::vector<osmium::object_id_type> swaps;
+    std::vector<size_t> swaps;
     
     if (from_tour.size() != to_tour.size()) return swaps;
     
-    std::vector<osmium::object_id_type> temp_tour = from_tour;
+    Tour temp_tour = from_tour;
     
     for (size_t i = 0; i < to_tour.size(); ++i) {
         if (temp_tour[i] != to_tour[i]) {
@@ -290,13 +287,13 @@ std::vector<osmium::object_id_type> PSOSolver::compute_swap_sequence(
     return swaps;
 }
 
-std::vector<osmium::object_id_type> PSOSolver::combine_swap_sequences(
-    const std::vector<osmium::object_id_type>& seq1,
-    const std::vector<osmium::object_id_type>& seq2,
+std::vector<size_t> PSOSolver::combine_swap_sequences(
+    const std::vector<size_t>& seq1,
+    const std::vector<size_t>& seq2,
     double weight1,
     double weight2) {
     
-    std::vector<osmium::object_id_type> combined;
+    std::vector<size_t> combined;
     
     // Ajouter des éléments de seq1 selon weight1
     int num_from_seq1 = static_cast<int>(seq1.size() * std::min(weight1, 1.0));
@@ -313,42 +310,31 @@ std::vector<osmium::object_id_type> PSOSolver::combine_swap_sequences(
     return combined;
 }
 
-// Amélioration locale 2-opt
-std::vector<osmium::object_id_type> PSOSolver::local_search_2opt(
-    const std::vector<osmium::object_id_type>& tour) {
+// Amélioration locale 2-opt jusqu'à l'optimum local (gains évalués en O(1))
+Tour PSOSolver::local_search_2opt(const Tour& tour) {
     
-    std::vector<osmium::object_id_type> best_tour = tour;
+    Tour best_tour = tour;
     double best_distance = calculate_tour_distance(tour);
-    bool improved = true;
+    const size_t n = best_tour.size();
     
-    while (improved) {
-        improved = false;
-        
-        for (size_t i = 1; i < tour.size() - 1; ++i) {
-            for (size_t j = i + 1; j < tour.size(); ++j) {
-                // Créer nouveau tour en inversant le segment [i, j]
-                std::vector<osmium::object_id_type> new_tour = best_tour;
-                std::reverse(new_tour.begin() + i, new_tour.begin() + j + 1);
-                
-                double new_distance = calculate_tour_distance(new_tour);
-                if (new_distance < best_distance) {
-                    best_tour = new_tour;
-                    best_distance = new_distance;
-                    improved = true;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_two_opt(best_tour, best_distance, neighbor_lists);
+        return best_tour;
+    }
+    
+    while (evaluator.best_two_opt(best_tour, best_distance, 1, n - 1, 1, n, false)) {
     }
     
     return best_tour;
 }
 
 // Mutation pour diversification
-std::vector<osmium::object_id_type> PSOSolver::mutate_tour(
-    const std::vector<osmium::object_id_type>& tour,
+Tour PSOSolver::mutate_tour(
+    const Tour& tour,
     double mutation_rate) {
     
-    std::vector<osmium::object_id_type> mutated = tour;
+    Tour mutated = tour;
     
     int num_mutations = static_cast<int>(tour.size() * mutation_rate);
     
@@ -364,66 +350,34 @@ std::vector<osmium::object_id_type> PSOSolver::mutate_tour(
 }
 
 // Évaluation des solutions
-double PSOSolver::evaluate_fitness(const std::vector<osmium::object_id_type>& tour) {
+double PSOSolver::evaluate_fitness(const Tour& tour) const {
     return calculate_tour_distance(tour);
 }
 
 // Méthodes utilitaires (similaires aux autres métaheuristiques)
-void PSOSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes) {
-    distance_cache.clear();
-    
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        for (size_t j = i + 1; j < nodes.size(); ++j) {
-            osmium::object_id_type node1 = nodes[i];
-            osmium::object_id_type node2 = nodes[j];
-            
-            std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
-            
-            double distance = 0.0;
-            if (!path.empty()) {
-                for (const auto& way_id : path) {
-                    auto way_it = geo_box.data.ways.find(way_id);
-                    if (way_it != geo_box.data.ways.end()) {
-                        distance += way_it->second.distance_meters;
-                    }
-                }
-            } else {
-                distance = std::numeric_limits<double>::max();
-            }
-            
-            auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-            distance_cache[key] = distance;
-        }
-    }
+void PSOSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads) {
+    // Une recherche un-vers-plusieurs par POI au lieu d'un A* par paire ;
+    // les tours sont ensuite exprimés en indices de cette matrice
+    distance_matrix = DistanceMatrix::build(pathfinder, nodes, num_threads);
 }
 
-double PSOSolver::get_distance(osmium::object_id_type node1, osmium::object_id_type node2) {
-    auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-    auto it = distance_cache.find(key);
-    return (it != distance_cache.end()) ? it->second : std::numeric_limits<double>::max();
+double PSOSolver::get_distance(size_t node1, size_t node2) const {
+    return distance_matrix.distance(node1, node2);
 }
 
-double PSOSolver::calculate_tour_distance(const std::vector<osmium::object_id_type>& tour) {
-    double total_distance = 0.0;
-    
-    for (size_t i = 0; i < tour.size(); ++i) {
-        size_t next_i = (i + 1) % tour.size();
-        total_distance += get_distance(tour[i], tour[next_i]);
-    }
-    
-    return total_distance;
+double PSOSolver::calculate_tour_distance(const Tour& tour) const {
+    return distance_matrix.tour_length(tour);
 }
 
 std::vector<osmium::object_id_type> PSOSolver::find_shortest_path(
     osmium::object_id_type start, 
     osmium::object_id_type end) {
     
-    Pathfinder temp_pathfinder(geo_box);
-    return temp_pathfinder.A_Star_Search(start, end);
+    return pathfinder.A_Star_Search(start, end);
 }
 
 void PSOSolver::apply_tour_to_ways(
-    const std::vector<osmium::object_id_type>& tour,
+    const Tour& tour,
     int group_id) {
 
     std::cout << "Application du tour PSO aux ways du groupe " << group_id << "..." << std::endl;
@@ -431,10 +385,8 @@ void PSOSolver::apply_tour_to_ways(
 
     for (size_t i = 0; i < tour.size(); ++i) {
         size_t next_i = (i + 1) % tour.size();
-        osmium::object_id_type node1 = tour[i];
-        osmium::object_id_type node2 = tour[next_i];
-
-        std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
+        // Chemin reconstruit depuis les arbres de prédécesseurs de la matrice
+        std::vector<osmium::object_id_type> path = distance_matrix.path(tour[i], tour[next_i]);
         
         for (const auto& way_id : path) {
             update_way_group(way_id, group_id);
@@ -454,14 +406,15 @@ void PSOSolver::update_way_group(osmium::object_id_type way_id, int new_group) {
     }
 }
 
-bool PSOSolver::is_valid_tour(
-    const std::vector<osmium::object_id_type>& tour,
-    const std::vector<osmium::object_id_type>& original_nodes) {
+bool PSOSolver::is_valid_tour(const Tour& tour) const {
+    const size_t n = distance_matrix.size();
+    if (tour.size() != n) return false;
     
-    if (tour.size() != original_nodes.size()) return false;
-    
-    std::unordered_set<osmium::object_id_type> tour_set(tour.begin(), tour.end());
-    std::unordered_set<osmium::object_id_type> original_set(original_nodes.begin(), original_nodes.end());
+    std::vector<char> seen(n, 0);
+    for (size_t node : tour) {
+        if (node >= n || seen[node]) return false;
+        seen[node] = 1;
+    }
     
-    return tour_set == original_set;
+    return true;
 }
\ No newline at end of file
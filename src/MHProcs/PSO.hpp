@@ -2,18 +2,18 @@
 #define PSO_HPP
 
 #include "../Box.hpp"
-#include "../Common/Hashes.hpp"
 #include "../Pathfinding.hpp"
+#include "DistanceMatrix.hpp"
+#include "MoveEvaluator.hpp"
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <random>
+#include <limits>
 
 // Structure pour représenter une particule (solution)
 struct Particle {
-    std::vector<osmium::object_id_type> position;    // Tour actuel
-    std::vector<osmium::object_id_type> velocity;    // "Vitesse" (changements à appliquer)
-    std::vector<osmium::object_id_type> best_position; // Meilleure position personnelle
+    Tour position;                                    // Tour actuel (indices de la matrice)
+    std::vector<size_t> velocity;                     // "Vitesse" (changements à appliquer)
+    Tour best_position;                               // Meilleure position personnelle
     double fitness;                                   // Distance du tour actuel
     double best_fitness;                             // Meilleure distance personnelle
     
@@ -31,7 +31,7 @@ struct Particle {
 
 // Structure pour stocker une solution PSO
 struct PSOSolution {
-    std::vector<osmium::object_id_type> tour;
+    Tour tour;  // Indices dans la matrice des distances
     double total_distance;
     bool is_valid;
     
@@ -53,6 +53,8 @@ struct PSOParams {
     double c2 = 1.5;              // Coefficient social (attraction vers meilleur global)
     double mutation_rate = 0.1;   // Taux de mutation pour diversification
     bool use_local_search = true; // Utiliser une recherche locale
+    int num_threads = 0;          // Threads du calcul des distances (0 = tous les cœurs)
+    int neighbor_list_size = 0;   // Voisins candidats par POI (0 = 2-opt complet)
     
     PSOParams() = default;
 };
@@ -61,14 +63,18 @@ struct PSOParams {
 class PSOSolver {
 private:
     GeoBox& geo_box;
+    Pathfinder pathfinder;  // Réutilisé pour toutes les recherches (heuristique précalculée)
     std::mt19937 rng;
     
-    // Cache des distances
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash> distance_cache;
+    // Matrice des distances (Dijkstra un-vers-plusieurs) et arbres de chemins
+    DistanceMatrix distance_matrix;
+    
+    // Plus proches voisins de chaque POI pour la recherche locale (vides sur les petits groupes)
+    NeighborLists neighbor_lists;
     
     // Essaim de particules
     std::vector<Particle> swarm;
-    std::vector<osmium::object_id_type> global_best_position;
+    Tour global_best_position;
     double global_best_fitness;
 
 public:
@@ -83,20 +89,12 @@ public:
 
 private:
     // Initialisation de l'essaim
-    void initialize_swarm(
-        const std::vector<osmium::object_id_type>& nodes,
-        const PSOParams& params
-    );
+    void initialize_swarm(const PSOParams& params);
     
     // Génération de positions initiales
-    std::vector<osmium::object_id_type> generate_random_tour(
-        const std::vector<osmium::object_id_type>& nodes
-    );
+    Tour generate_random_tour();
     
-    std::vector<osmium::object_id_type> nearest_neighbor_tour(
-        const std::vector<osmium::object_id_type>& nodes,
-        osmium::object_id_type start_node
-    );
+    Tour nearest_neighbor_tour(size_t start_node);
     
     // Mise à jour des particules
     void update_particle_velocity(
@@ -104,47 +102,42 @@ private:
         const PSOParams& params
     );
     
-    void update_particle_position(
-        Particle& particle,
-        const std::vector<osmium::object_id_type>& nodes
-    );
+    void update_particle_position(Particle& particle);
     
     // Opérateurs pour TSP adapté à PSO
-    std::vector<osmium::object_id_type> apply_swap_sequence(
-        const std::vector<osmium::object_id_type>& tour,
-        const std::vector<osmium::object_id_type>& swaps
+    Tour apply_swap_sequence(
+        const Tour& tour,
+        const std::vector<size_t>& swaps
     );
     
-    std::vector<osmium::object_id_type> compute_swap_sequence(
-        const std::vector<osmium::object_id_type>& from_tour,
-        const std::vector<osmium::object_id_type>& to_tour
+    std::vector<size_t> compute_swap_sequence(
+        const Tour& from_tour,
+        const Tour& to_tour
     );
     
-    std::vector<osmium::object_id_type> combine_swap_sequences(
-        const std::vector<osmium::object_id_type>& seq1,
-        const std::vector<osmium::object_id_type>& seq2,
+    std::vector<size_t> combine_swap_sequences(
+        const std::vector<size_t>& seq1,
+        const std::vector<size_t>& seq2,
         double weight1,
         double weight2
     );
     
     // Amélioration locale
-    std::vector<osmium::object_id_type> local_search_2opt(
-        const std::vector<osmium::object_id_type>& tour
-    );
+    Tour local_search_2opt(const Tour& tour);
     
     // Mutation pour diversification
-    std::vector<osmium::object_id_type> mutate_tour(
-        const std::vector<osmium::object_id_type>& tour,
+    Tour mutate_tour(
+        const Tour& tour,
         double mutation_rate
     );
     
     // Évaluation des solutions
-    double evaluate_fitness(const std::vector<osmium::object_id_type>& tour);
+    double evaluate_fitness(const Tour& tour) const;
     
     // Méthodes utilitaires
-    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes);
-    double get_distance(osmium::object_id_type node1, osmium::object_id_type node2);
-    double calculate_tour_distance(const std::vector<osmium::object_id_type>& tour);
+    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads);
+    double get_distance(size_t node1, size_t node2) const;
+    double calculate_tour_distance(const Tour& tour) const;
     
     std::vector<osmium::object_id_type> find_shortest_path(
         osmium::object_id_type start, 
@@ -152,17 +145,14 @@ private:
     );
     
     void apply_tour_to_ways(
-        const std::vector<osmium::object_id_type>& tour,
+        const Tour& tour,
         int group_id
     );
     
     void update_way_group(osmium::object_id_type way_id, int new_group);
     
-    // Validation
-    bool is_valid_tour(
-        const std::vector<osmium::object_id_type>& tour,
-        const std::vector<osmium::object_id_type>& original_nodes
-    );
+    // Validation : le tour est une permutation de 0..n-1
+    bool is_valid_tour(const Tour& tour) const;
 };
 
 #endif // PSO_HPP
\ No newline at end of file
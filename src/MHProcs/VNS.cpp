@@ -5,7 +5,7 @@
 #include <chrono>
 
 // Constructeur
-VNSSolver::VNSSolver(GeoBox& box) : geo_box(box) {
+VNSSolver::VNSSolver(GeoBox& box) : geo_box(box), pathfinder(box) {
     // Initialiser le générateur de nombres aléatoires
     rng.seed(std::chrono::steady_clock::now().time_since_epoch().count());
 }
@@ -26,10 +26,11 @@ bool VNSSolver::solve_single_group(
 
     // 1. Construire le cache des distances
     std::cout << "Construction du cache des distances..." << std::endl;
-    build_distance_cache(objective_nodes);
+    build_distance_cache(objective_nodes, params.num_threads);
+    neighbor_lists = NeighborLists::build(distance_matrix, static_cast<size_t>(std::max(0, params.neighbor_list_size)));
 
     // 2. Générer une solution initiale
-    VNSSolution current_solution = generate_initial_solution(objective_nodes);
+    VNSSolution current_solution = generate_initial_solution();
     if (!current_solution.is_valid) {
         std::cout << "VNS: Impossible de générer une solution initiale" << std::endl;
         return false;
@@ -87,28 +88,32 @@ bool VNSSolver::solve_single_group(
 }
 
 // Génération de solution initiale
-VNSSolution VNSSolver::generate_initial_solution(const std::vector<osmium::object_id_type>& nodes) {
+VNSSolution VNSSolver::generate_initial_solution() {
     // Utiliser l'heuristique du plus proche voisin
-    return nearest_neighbor_heuristic(nodes);
+    return nearest_neighbor_heuristic();
 }
 
-VNSSolution VNSSolver::nearest_neighbor_heuristic(const std::vector<osmium::object_id_type>& nodes) {
+VNSSolution VNSSolver::nearest_neighbor_heuristic() {
     VNSSolution solution;
+    const size_t n = distance_matrix.size();
     
-    if (nodes.empty()) return solution;
+    if (n == 0) return solution;
     
     // Commencer par le premier nœud
-    osmium::object_id_type current = nodes[0];
+    size_t current = 0;
+    solution.tour.reserve(n);
     solution.tour.push_back(current);
     
-    std::unordered_set<osmium::object_id_type> unvisited(nodes.begin() + 1, nodes.end());
+    std::vector<char> visited(n, 0);
+    visited[current] = 1;
     
     // Construire le tour avec l'heuristique du plus proche voisin
-    while (!unvisited.empty()) {
-        osmium::object_id_type nearest = 0;
+    while (solution.tour.size() < n) {
+        size_t nearest = n;
         double min_distance = std::numeric_limits<double>::max();
         
-        for (const auto& candidate : unvisited) {
+        for (size_t candidate = 0; candidate < n; ++candidate) {
+            if (visited[candidate]) continue;
             double distance = get_distance(current, candidate);
             if (distance < min_distance) {
                 min_distance = distance;
@@ -116,16 +121,16 @@ VNSSolution VNSSolver::nearest_neighbor_heuristic(const std::vector<osmium::obje
             }
         }
         
-        if (nearest != 0) {
+        if (nearest != n) {
             solution.tour.push_back(nearest);
-            unvisited.erase(nearest);
+            visited[nearest] = 1;
             current = nearest;
         } else {
             break;
         }
     }
     
-    if (solution.tour.size() == nodes.size()) {
+    if (solution.tour.size() == n) {
         solution.total_distance = calculate_tour_distance(solution.tour);
         solution.is_valid = true;
     }
@@ -188,52 +193,35 @@ VNSSolution VNSSolver::local_search(
     }
 }
 
-// Structure de voisinage 2-opt
+// Structure de voisinage 2-opt : inversion du segment [i, j], gain évalué en O(1).
+// Avec les listes de candidats, chaque voisinage est une descente jusqu'à l'optimum local.
 VNSSolution VNSSolver::two_opt_neighborhood(const VNSSolution& solution, bool first_improvement) {
     VNSSolution best = solution;
+    const size_t n = best.tour.size();
     
-    for (size_t i = 1; i < solution.tour.size() - 1; ++i) {
-        for (size_t j = i + 1; j < solution.tour.size(); ++j) {
-            // Créer nouveau tour en inversant le segment [i, j]
-            std::vector<osmium::object_id_type> new_tour = solution.tour;
-            std::reverse(new_tour.begin() + i, new_tour.begin() + j + 1);
-            
-            double new_distance = calculate_tour_distance(new_tour);
-            if (new_distance < best.total_distance) {
-                best.tour = new_tour;
-                best.total_distance = new_distance;
-                
-                if (first_improvement) {
-                    return best;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_two_opt(best.tour, best.total_distance, neighbor_lists);
+        return best;
     }
+    evaluator.best_two_opt(best.tour, best.total_distance, 1, n - 1, 1, n, first_improvement);
     
     return best;
 }
 
-// Structure de voisinage 3-opt (version simplifiée)
+// Structure de voisinage 3-opt (version simplifiée : inversion de segments d'au moins 3 POI ;
+// Or-opt, sous-ensemble du 3-opt, avec les listes de candidats)
 VNSSolution VNSSolver::three_opt_neighborhood(const VNSSolution& solution, bool first_improvement) {
     VNSSolution best = solution;
+    const size_t n = best.tour.size();
+    if (n < 3) return best;
     
-    for (size_t i = 0; i < solution.tour.size() - 2; ++i) {
-        for (size_t j = i + 2; j < solution.tour.size(); ++j) {
-            // Version simplifiée: juste inverser un segment
-            std::vector<osmium::object_id_type> new_tour = solution.tour;
-            std::reverse(new_tour.begin() + i, new_tour.begin() + j + 1);
-            
-            double new_distance = calculate_tour_distance(new_tour);
-            if (new_distance < best.total_distance) {
-                best.tour = new_tour;
-                best.total_distance = new_distance;
-                
-                if (first_improvement) {
-                    return best;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_or_opt(best.tour, best.total_distance, neighbor_lists, 3);
+        return best;
     }
+    evaluator.best_two_opt(best.tour, best.total_distance, 0, n - 2, 2, n, first_improvement);
     
     return best;
 }
@@ -242,27 +230,12 @@ VNSSolution VNSSolver::three_opt_neighborhood(const VNSSolution& solution, bool
 VNSSolution VNSSolver::relocate_neighborhood(const VNSSolution& solution, bool first_improvement) {
     VNSSolution best = solution;
     
-    for (size_t i = 0; i < solution.tour.size(); ++i) {
-        for (size_t j = 0; j < solution.tour.size(); ++j) {
-            if (i == j) continue;
-            
-            // Déplacer l'élément i vers la position j
-            std::vector<osmium::object_id_type> new_tour = solution.tour;
-            osmium::object_id_type element = new_tour[i];
-            new_tour.erase(new_tour.begin() + i);
-            new_tour.insert(new_tour.begin() + (j > i ? j - 1 : j), element);
-            
-            double new_distance = calculate_tour_distance(new_tour);
-            if (new_distance < best.total_distance) {
-                best.tour = new_tour;
-                best.total_distance = new_distance;
-                
-                if (first_improvement) {
-                    return best;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_or_opt(best.tour, best.total_distance, neighbor_lists, 1);
+        return best;
     }
+    evaluator.best_relocate(best.tour, best.total_distance, first_improvement);
     
     return best;
 }
@@ -271,23 +244,12 @@ VNSSolution VNSSolver::relocate_neighborhood(const VNSSolution& solution, bool f
 VNSSolution VNSSolver::swap_neighborhood(const VNSSolution& solution, bool first_improvement) {
     VNSSolution best = solution;
     
-    for (size_t i = 0; i < solution.tour.size(); ++i) {
-        for (size_t j = i + 1; j < solution.tour.size(); ++j) {
-            // Échanger les éléments i et j
-            std::vector<osmium::object_id_type> new_tour = solution.tour;
-            std::swap(new_tour[i], new_tour[j]);
-            
-            double new_distance = calculate_tour_distance(new_tour);
-            if (new_distance < best.total_distance) {
-                best.tour = new_tour;
-                best.total_distance = new_distance;
-                
-                if (first_improvement) {
-                    return best;
-                }
-            }
-        }
+    MoveEvaluator evaluator(distance_matrix);
+    if (!neighbor_lists.empty()) {
+        evaluator.improve_swap(best.tour, best.total_distance, neighbor_lists);
+        return best;
     }
+    evaluator.best_swap(best.tour, best.total_distance, first_improvement);
     
     return best;
 }
@@ -320,7 +282,7 @@ VNSSolution VNSSolver::random_relocations(const VNSSolution& solution, int num_r
         size_t to = dist(rng);
         
         if (from != to) {
-            osmium::object_id_type element = result.tour[from];
+            size_t element = result.tour[from];
             result.tour.erase(result.tour.begin() + from);
             result.tour.insert(result.tour.begin() + (to > from ? to - 1 : to), element);
         }
@@ -346,61 +308,29 @@ VNSSolution VNSSolver::random_swaps(const VNSSolution& solution, int num_swaps)
 }
 
 // Méthodes utilitaires (similaires à GRASP et ACO)
-void VNSSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes) {
-    distance_cache.clear();
-    
-    for (size_t i = 0; i < nodes.size(); ++i) {
-        for (size_t j = i + 1; j < nodes.size(); ++j) {
-            osmium::object_id_type node1 = nodes[i];
-            osmium::object_id_type node2 = nodes[j];
-            
-            std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
-            
-            double distance = 0.0;
-            if (!path.empty()) {
-                for (const auto& way_id : path) {
-                    auto way_it = geo_box.data.ways.find(way_id);
-                    if (way_it != geo_box.data.ways.end()) {
-                        distance += way_it->second.distance_meters;
-                    }
-                }
-            } else {
-                distance = std::numeric_limits<double>::max();
-            }
-            
-            auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-            distance_cache[key] = distance;
-        }
-    }
+void VNSSolver::build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads) {
+    // Une recherche un-vers-plusieurs par POI au lieu d'un A* par paire ;
+    // les tours sont ensuite exprimés en indices de cette matrice
+    distance_matrix = DistanceMatrix::build(pathfinder, nodes, num_threads);
 }
 
-double VNSSolver::get_distance(osmium::object_id_type node1, osmium::object_id_type node2) {
-    auto key = std::make_pair(std::min(node1, node2), std::max(node1, node2));
-    auto it = distance_cache.find(key);
-    return (it != distance_cache.end()) ? it->second : std::numeric_limits<double>::max();
+double VNSSolver::get_distance(size_t node1, size_t node2) const {
+    return distance_matrix.distance(node1, node2);
 }
 
-double VNSSolver::calculate_tour_distance(const std::vector<osmium::object_id_type>& tour) {
-    double total_distance = 0.0;
-    
-    for (size_t i = 0; i < tour.size(); ++i) {
-        size_t next_i = (i + 1) % tour.size();
-        total_distance += get_distance(tour[i], tour[next_i]);
-    }
-    
-    return total_distance;
+double VNSSolver::calculate_tour_distance(const Tour& tour) const {
+    return distance_matrix.tour_length(tour);
 }
 
 std::vector<osmium::object_id_type> VNSSolver::find_shortest_path(
     osmium::object_id_type start, 
     osmium::object_id_type end) {
     
-    Pathfinder temp_pathfinder(geo_box);
-    return temp_pathfinder.A_Star_Search(start, end);
+    return pathfinder.A_Star_Search(start, end);
 }
 
 void VNSSolver::apply_tour_to_ways(
-    const std::vector<osmium::object_id_type>& tour,
+    const Tour& tour,
     int group_id) {
 
     std::cout << "Application du tour VNS aux ways du groupe " << group_id << "..." << std::endl;
@@ -408,10 +338,8 @@ void VNSSolver::apply_tour_to_ways(
 
     for (size_t i = 0; i < tour.size(); ++i) {
         size_t next_i = (i + 1) % tour.size();
-        osmium::object_id_type node1 = tour[i];
-        osmium::object_id_type node2 = tour[next_i];
-
-        std::vector<osmium::object_id_type> path = find_shortest_path(node1, node2);
+        // Chemin reconstruit depuis les arbres de prédécesseurs de la matrice
+        std::vector<osmium::object_id_type> path = distance_matrix.path(tour[i], tour[next_i]);
         
         for (const auto& way_id : path) {
             update_way_group(way_id, group_id);
@@ -431,7 +359,6 @@ void VNSSolver::update_way_group(osmium::object_id_type way_id, int new_group) {
     }
 }
 
-bool VNSSolver::is_valid_tour(const std::vector<osmium::object_id_type>& tour, 
-                             const std::vector<osmium::object_id_type>& original_nodes) {
-    return tour.size() == original_nodes.size();
+bool VNSSolver::is_valid_tour(const Tour& tour) const {
+    return tour.size() == distance_matrix.size();
 }
\ No newline at end of file
@@ -2,16 +2,15 @@
 #define VNS_HPP
 
 #include "../Box.hpp"
-#include "../Common/Hashes.hpp"
 #include "../Pathfinding.hpp"
+#include "DistanceMatrix.hpp"
+#include "MoveEvaluator.hpp"
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <random>
 
 // Structure pour stocker une solution VNS
 struct VNSSolution {
-    std::vector<osmium::object_id_type> tour;
+    Tour tour;  // Indices dans la matrice des distances
     double total_distance;
     bool is_valid;
     
@@ -35,6 +34,8 @@ struct VNSParams {
     double shaking_intensity = 0.3;     // Intensité des perturbations (0.1-0.5)
     bool use_first_improvement = true;  // Arrêter dès la première amélioration
     bool diversification = true;        // Utiliser la diversification
+    int num_threads = 0;                // Threads du calcul des distances (0 = tous les cœurs)
+    int neighbor_list_size = 0;         // Voisins candidats par POI (0 = voisinages complets)
     
     VNSParams() = default;
 };
@@ -51,10 +52,14 @@ enum class NeighborhoodType {
 class VNSSolver {
 private:
     GeoBox& geo_box;
+    Pathfinder pathfinder;  // Réutilisé pour toutes les recherches (heuristique précalculée)
     std::mt19937 rng;
     
-    // Cache des distances pour éviter les recalculs
-    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, PairHash> distance_cache;
+    // Matrice des distances (Dijkstra un-vers-plusieurs) et arbres de chemins
+    DistanceMatrix distance_matrix;
+    
+    // Plus proches voisins de chaque POI pour la recherche locale (vides sur les petits groupes)
+    NeighborLists neighbor_lists;
 
 public:
     explicit VNSSolver(GeoBox& box);
@@ -68,8 +73,8 @@ public:
 
 private:
     // Génération de solution initiale
-    VNSSolution generate_initial_solution(const std::vector<osmium::object_id_type>& nodes);
-    VNSSolution nearest_neighbor_heuristic(const std::vector<osmium::object_id_type>& nodes);
+    VNSSolution generate_initial_solution();
+    VNSSolution nearest_neighbor_heuristic();
     
     // Phase de secousse (shaking)
     VNSSolution shaking(
@@ -97,9 +102,9 @@ private:
     VNSSolution random_swaps(const VNSSolution& solution, int num_swaps);
     
     // Méthodes utilitaires
-    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes);
-    double get_distance(osmium::object_id_type node1, osmium::object_id_type node2);
-    double calculate_tour_distance(const std::vector<osmium::object_id_type>& tour);
+    void build_distance_cache(const std::vector<osmium::object_id_type>& nodes, int num_threads);
+    double get_distance(size_t node1, size_t node2) const;
+    double calculate_tour_distance(const Tour& tour) const;
     
     std::vector<osmium::object_id_type> find_shortest_path(
         osmium::object_id_type start, 
@@ -107,15 +112,14 @@ private:
     );
     
     void apply_tour_to_ways(
-        const std::vector<osmium::object_id_type>& tour,
+        const Tour& tour,
         int group_id
     );
     
     void update_way_group(osmium::object_id_type way_id, int new_group);
     
     // Vérification de validité
-    bool is_valid_tour(const std::vector<osmium::object_id_type>& tour, 
-                      const std::vector<osmium::object_id_type>& original_nodes);
+    bool is_valid_tour(const Tour& tour) const;
 };
 
 #endif // VNS_HPP
\ No newline at end of file
@@ -0,0 +1,523 @@
+#include "MappedGeoBox.hpp"
+#include "RoadGraph.hpp"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'G', 'E', 'O', 'B', 'O', 'X', 'B', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;  // Relu différemment sur une machine d'un autre boutisme
+
+enum Section : uint32_t {
+    NODE_IDS,
+    NODE_BY_ID,
+    NODE_LATS,
+    NODE_LONS,
+    NODE_POSITIONS,
+    NODE_GROUPS,
+    OBJECTIVE_OFFSETS,
+    OBJECTIVE_CHARS,
+    INCIDENT_OFFSETS,
+    INCIDENT_WAYS,
+    EDGE_OFFSETS,
+    EDGE_TARGETS,
+    EDGE_WEIGHTS,
+    EDGE_WAYS,
+    WAY_IDS,
+    WAY_NODE1_IDS,
+    WAY_NODE2_IDS,
+    WAY_DISTANCES,
+    WAY_GROUPS,
+    EXTRA_GROUPS,
+    METADATA,
+    SECTION_COUNT
+};
+
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    int64_t timestamp;
+    uint32_t node_count;
+    uint32_t edge_count;
+    uint32_t way_count;
+    uint32_t incident_count;
+    uint32_t extra_group_count;
+    uint32_t reserved;
+    SectionEntry sections[SECTION_COUNT];
+};
+static_assert(sizeof(FileHeader) % 8 == 0, "Les sections doivent rester alignées sur 8 octets");
+
+// Écrit les sections à la suite, chacune alignée sur 8 octets, et les inscrit dans l'en-tête
+class SectionWriter {
+public:
+    SectionWriter(std::ofstream& out, FileHeader& header)
+        : out(out), header(header), position(sizeof(FileHeader)) {}
+
+    template <typename T>
+    void add(Section section, const T* values, size_t count) {
+        pad();
+        const uint64_t bytes = static_cast<uint64_t>(count) * sizeof(T);
+        header.sections[section] = {position, bytes};
+        if (bytes > 0) out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(bytes));
+        position += bytes;
+    }
+
+    template <typename T>
+    void add(Section section, const std::vector<T>& values) {
+        add(section, values.data(), values.size());
+    }
+
+    uint64_t finish() {
+        pad();
+        return position;
+    }
+
+private:
+    std::ofstream& out;
+    FileHeader& header;
+    uint64_t position;
+
+    void pad() {
+        while (position % 8 != 0) {
+            out.put('\0');
+            ++position;
+        }
+    }
+};
+
+template <typename T>
+void append_pod(std::vector<char>& bytes, const T& value) {
+    const char* raw = reinterpret_cast<const char*>(&value);
+    bytes.insert(bytes.end(), raw, raw + sizeof(T));
+}
+
+void append_string(std::vector<char>& bytes, const std::string& value) {
+    append_pod(bytes, static_cast<uint32_t>(value.size()));
+    bytes.insert(bytes.end(), value.begin(), value.end());
+}
+
+// Lecture bornée des métadonnées : toute lecture hors limites rend le curseur invalide
+class MetadataReader {
+public:
+    MetadataReader(const char* bytes, size_t size) : bytes(bytes), size(size) {}
+
+    template <typename T>
+    T pod() {
+        T value{};
+        if (ok && offset + sizeof(T) <= size) {
+            std::memcpy(&value, bytes + offset, sizeof(T));
+            offset += sizeof(T);
+        } else {
+            ok = false;
+        }
+        return value;
+    }
+
+    std::string string() {
+        const uint32_t length = pod<uint32_t>();
+        if (!ok || offset + length > size) {
+            ok = false;
+            return {};
+        }
+        std::string value(bytes + offset, length);
+        offset += length;
+        return value;
+    }
+
+    bool good() const { return ok; }
+
+private:
+    const char* bytes;
+    size_t size;
+    size_t offset = 0;
+    bool ok = true;
+};
+
+} // namespace
+
+bool MappedGeoBox::write(const GeoBox& geo_box, const std::string& filepath) {
+    const MyData& data = geo_box.data;
+
+    // Ordre des nodes et adjacence : ceux de l'instantané de routage (courbe de Hilbert)
+    const RoadGraph graph = RoadGraph::build(data);
+    const uint32_t n = graph.num_nodes();
+    const uint32_t m = graph.num_edges();
+
+    std::vector<osmium::object_id_type> way_ids;
+    way_ids.reserve(data.ways.size());
+    for (const auto& [way_id, way] : data.ways) {
+        way_ids.push_back(way_id);
+    }
+    std::sort(way_ids.begin(), way_ids.end());
+    auto way_index = [&](osmium::object_id_type way_id) {
+        return static_cast<uint32_t>(std::lower_bound(way_ids.begin(), way_ids.end(), way_id) - way_ids.begin());
+    };
+
+    std::vector<ExtraGroup> extra_groups;
+
+    // Nodes
+    std::vector<osmium::object_id_type> node_ids(n);
+    std::vector<double> lats(n), lons(n), positions(3 * static_cast<size_t>(n));
+    std::vector<uint64_t> node_groups(n);
+    std::vector<uint32_t> objective_offsets(n + 1, 0), incident_offsets(n + 1, 0);
+    std::vector<char> objective_chars;
+    std::vector<osmium::object_id_type> incident_ways;
+
+    for (uint32_t u = 0; u < n; ++u) {
+        const MyData::Point& point = data.nodes.at(graph.node_id(u));
+        node_ids[u] = graph.node_id(u);
+        lats[u] = graph.lat(u);
+        lons[u] = graph.lon(u);
+        std::copy(graph.position(u).begin(), graph.position(u).end(), positions.begin() + 3 * static_cast<size_t>(u));
+        node_groups[u] = point.groupes.inline_mask();
+        for (int group : point.groupes) {
+            if (group >= GroupSet::INLINE_BITS) extra_groups.push_back({u, group});
+        }
+
+        objective_chars.insert(objective_chars.end(), point.objective_id.begin(), point.objective_id.end());
+        objective_offsets[u + 1] = static_cast<uint32_t>(objective_chars.size());
+        incident_ways.insert(incident_ways.end(), point.incident_ways.begin(), point.incident_ways.end());
+        incident_offsets[u + 1] = static_cast<uint32_t>(incident_ways.size());
+    }
+
+    std::vector<uint32_t> node_by_id(n);
+    std::iota(node_by_id.begin(), node_by_id.end(), 0u);
+    std::sort(node_by_id.begin(), node_by_id.end(),
+              [&](uint32_t a, uint32_t b) { return node_ids[a] < node_ids[b]; });
+
+    // Adjacence
+    std::vector<uint32_t> edge_offsets(n + 1), edge_targets(m), edge_ways(m);
+    std::vector<float> edge_weights(m);
+    for (uint32_t u = 0; u <= n; ++u) {
+        edge_offsets[u] = (u < n) ? graph.edge_begin(u) : m;
+    }
+    for (uint32_t e = 0; e < m; ++e) {
+        edge_targets[e] = graph.edge_target(e);
+        edge_weights[e] = graph.edge_weight(e);
+        edge_ways[e] = way_index(graph.edge_way_id(e));
+    }
+
+    // Ways
+    const uint32_t w_count = static_cast<uint32_t>(way_ids.size());
+    std::vector<osmium::object_id_type> way_node1_ids(w_count), way_node2_ids(w_count);
+    std::vector<float> way_distances(w_count);
+    std::vector<uint64_t> way_groups(w_count);
+    for (uint32_t w = 0; w < w_count; ++w) {
+        const MyData::Way& way = data.ways.at(way_ids[w]);
+        way_node1_ids[w] = way.node1_id;
+        way_node2_ids[w] = way.node2_id;
+        way_distances[w] = way.distance_meters;
+        way_groups[w] = way.groupes.inline_mask();
+        for (int group : way.groupes) {
+            if (group >= GroupSet::INLINE_BITS) extra_groups.push_back({w | WAY_ITEM, group});
+        }
+    }
+
+    // Métadonnées : bbox, fichier source, groupes d'objectifs
+    std::vector<char> metadata;
+    append_pod(metadata, static_cast<uint8_t>(geo_box.bbox.valid() ? 1 : 0));
+    append_pod(metadata, geo_box.bbox.valid() ? geo_box.bbox.bottom_left().lon() : 0.0);
+    append_pod(metadata, geo_box.bbox.valid() ? geo_box.bbox.bottom_left().lat() : 0.0);
+    append_pod(metadata, geo_box.bbox.valid() ? geo_box.bbox.top_right().lon() : 0.0);
+    append_pod(metadata, geo_box.bbox.valid() ? geo_box.bbox.top_right().lat() : 0.0);
+    append_string(metadata, geo_box.source_file);
+    append_pod(metadata, static_cast<uint32_t>(data.objective_groups.size()));
+    for (const auto& [group_id, group] : data.objective_groups) {
+        append_pod(metadata, static_cast<int32_t>(group_id));
+        append_pod(metadata, static_cast<int32_t>(group.id));
+        append_pod(metadata, static_cast<int32_t>(group.point_count));
+        append_string(metadata, group.name);
+        append_string(metadata, group.description);
+        append_pod(metadata, static_cast<uint64_t>(group.node_ids.size()));
+        for (osmium::object_id_type node_id : group.node_ids) {
+            append_pod(metadata, node_id);
+        }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.timestamp = static_cast<int64_t>(std::time(nullptr));
+    header.node_count = n;
+    header.edge_count = m;
+    header.way_count = w_count;
+    header.incident_count = static_cast<uint32_t>(incident_ways.size());
+    header.extra_group_count = static_cast<uint32_t>(extra_groups.size());
+
+    const std::string temp_path = filepath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Cannot open file for writing: " << temp_path << std::endl;
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));  // Réécrit à la fin
+
+        SectionWriter sections(out, header);
+        sections.add(NODE_IDS, node_ids);
+        sections.add(NODE_BY_ID, node_by_id);
+        sections.add(NODE_LATS, lats);
+        sections.add(NODE_LONS, lons);
+        sections.add(NODE_POSITIONS, positions);
+        sections.add(NODE_GROUPS, node_groups);
+        sections.add(OBJECTIVE_OFFSETS, objective_offsets);
+        sections.add(OBJECTIVE_CHARS, objective_chars);
+        sections.add(INCIDENT_OFFSETS, incident_offsets);
+        sections.add(INCIDENT_WAYS, incident_ways);
+        sections.add(EDGE_OFFSETS, edge_offsets);
+        sections.add(EDGE_TARGETS, edge_targets);
+        sections.add(EDGE_WEIGHTS, edge_weights);
+        sections.add(EDGE_WAYS, edge_ways);
+        sections.add(WAY_IDS, way_ids);
+        sections.add(WAY_NODE1_IDS, way_node1_ids);
+        sections.add(WAY_NODE2_IDS, way_node2_ids);
+        sections.add(WAY_DISTANCES, way_distances);
+        sections.add(WAY_GROUPS, way_groups);
+        sections.add(EXTRA_GROUPS, extra_groups);
+        sections.add(METADATA, metadata);
+        header.file_size = sections.finish();
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        written = !out.fail();
+        if (!written) std::cerr << "Erreur d'écriture: " << temp_path << std::endl;
+    }
+    if (!written) {
+        std::error_code error;
+        std::filesystem::remove(temp_path, error);  // Ne pas laisser de .tmp partiel
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, filepath, error);
+    if (error) {
+        std::cerr << "Impossible de renommer " << temp_path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+bool MappedGeoBox::is_binary_cache(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    char magic[sizeof(CACHE_MAGIC)] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0;
+}
+
+MappedGeoBox MappedGeoBox::open(const std::string& filepath) {
+    MappedGeoBox view;
+
+    std::error_code error;
+    const auto size_on_disk = std::filesystem::file_size(filepath, error);
+    if (error || size_on_disk < sizeof(FileHeader)) return view;
+
+    auto file = std::make_shared<boost::iostreams::mapped_file_source>();
+    try {
+        file->open(filepath);
+    } catch (const std::exception& e) {
+        std::cerr << "Projection impossible de " << filepath << ": " << e.what() << std::endl;
+        return view;
+    }
+
+    const char* base = file->data();
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != FORMAT_VERSION
+        || header.byte_order != BYTE_ORDER_MARK
+        || header.file_size != file->size()) {
+        return view;
+    }
+
+    const size_t n = header.node_count;
+    bool ok = true;
+
+    // Pointeur sur une section dont la taille doit valoir count éléments de type T
+    auto section = [&]<typename T>(Section id, size_t count, const T*) -> const T* {
+        const SectionEntry& entry = header.sections[id];
+        if (entry.offset % 8 != 0 || entry.offset + entry.bytes > header.file_size
+            || entry.bytes != count * sizeof(T)) {
+            ok = false;
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(base + entry.offset);
+    };
+
+    view.node_count = header.node_count;
+    view.edge_count = header.edge_count;
+    view.way_count = header.way_count;
+    view.incident_count = header.incident_count;
+    view.extra_group_count = header.extra_group_count;
+
+    view.node_ids = section(NODE_IDS, n, view.node_ids);
+    view.node_by_id = section(NODE_BY_ID, n, view.node_by_id);
+    view.lats = section(NODE_LATS, n, view.lats);
+    view.lons = section(NODE_LONS, n, view.lons);
+    view.positions = section(NODE_POSITIONS, 3 * n, view.positions);
+    view.node_groups = section(NODE_GROUPS, n, view.node_groups);
+    view.objective_offsets = section(OBJECTIVE_OFFSETS, n + 1, view.objective_offsets);
+    view.incident_offsets = section(INCIDENT_OFFSETS, n + 1, view.incident_offsets);
+    view.incident_ways = section(INCIDENT_WAYS, header.incident_count, view.incident_ways);
+    view.edge_offsets = section(EDGE_OFFSETS, n + 1, view.edge_offsets);
+    view.edge_targets = section(EDGE_TARGETS, header.edge_count, view.edge_targets);
+    view.edge_weights = section(EDGE_WEIGHTS, header.edge_count, view.edge_weights);
+    view.edge_ways = section(EDGE_WAYS, header.edge_count, view.edge_ways);
+    view.way_ids = section(WAY_IDS, header.way_count, view.way_ids);
+    view.way_node1_ids = section(WAY_NODE1_IDS, header.way_count, view.way_node1_ids);
+    view.way_node2_ids = section(WAY_NODE2_IDS, header.way_count, view.way_node2_ids);
+    view.way_distances = section(WAY_DISTANCES, header.way_count, view.way_distances);
+    view.way_groups = section(WAY_GROUPS, header.way_count, view.way_groups);
+    view.extra_groups = section(EXTRA_GROUPS, header.extra_group_count, view.extra_groups);
+    if (!ok) return MappedGeoBox();
+
+    // Tailles variables : cohérence des CSR avec les sections
+    const SectionEntry& chars = header.sections[OBJECTIVE_CHARS];
+    const SectionEntry& metadata = header.sections[METADATA];
+    if (view.objective_offsets[n] != chars.bytes || chars.offset + chars.bytes > header.file_size
+        || view.incident_offsets[n] != header.incident_count || view.edge_offsets[n] != header.edge_count
+        || metadata.offset + metadata.bytes > header.file_size) {
+        return MappedGeoBox();
+    }
+    view.objective_chars = base + chars.offset;
+
+    if (!view.validate()) {
+        std::cerr << "Cache binaire incohérent: " << filepath << std::endl;
+        return MappedGeoBox();
+    }
+    if (!view.read_metadata(base + metadata.offset, metadata.bytes)) return MappedGeoBox();
+
+    view.file = std::move(file);
+    return view;
+}
+
+bool MappedGeoBox::read_metadata(const char* bytes, size_t size) {
+    MetadataReader reader(bytes, size);
+
+    valid_box = reader.pod<uint8_t>() != 0;
+    const double min_lon = reader.pod<double>();
+    const double min_lat = reader.pod<double>();
+    const double max_lon = reader.pod<double>();
+    const double max_lat = reader.pod<double>();
+    if (valid_box) {
+        box.extend(osmium::Location(min_lon, min_lat));
+        box.extend(osmium::Location(max_lon, max_lat));
+    }
+    source = reader.string();
+
+    const uint32_t group_count = reader.pod<uint32_t>();
+    for (uint32_t i = 0; i < group_count && reader.good(); ++i) {
+        const int group_id = reader.pod<int32_t>();
+        ObjectiveGroup group;
+        group.id = reader.pod<int32_t>();
+        group.point_count = reader.pod<int32_t>();
+        group.name = reader.string();
+        group.description = reader.string();
+        const uint64_t node_count_in_group = reader.pod<uint64_t>();
+        if (node_count_in_group > size) return false;
+        group.node_ids.reserve(node_count_in_group);
+        for (uint64_t k = 0; k < node_count_in_group && reader.good(); ++k) {
+            group.node_ids.push_back(reader.pod<osmium::object_id_type>());
+        }
+        groups[group_id] = std::move(group);
+    }
+    return reader.good();
+}
+
+bool MappedGeoBox::validate() const {
+    auto offsets_ok = [this](const uint32_t* offsets) {
+        if (offsets[0] != 0) return false;
+        for (uint32_t u = 0; u < node_count; ++u) {
+            if (offsets[u + 1] < offsets[u]) return false;
+        }
+        return true;
+    };
+    if (!offsets_ok(objective_offsets) || !offsets_ok(incident_offsets) || !offsets_ok(edge_offsets)) {
+        return false;
+    }
+
+    for (uint32_t e = 0; e < edge_count; ++e) {
+        if (edge_targets[e] >= node_count || edge_ways[e] >= way_count) return false;
+    }
+
+    for (uint32_t i = 0; i < node_count; ++i) {
+        if (node_by_id[i] >= node_count) return false;
+        if (i > 0 && node_ids[node_by_id[i]] <= node_ids[node_by_id[i - 1]]) return false;
+    }
+    for (uint32_t w = 1; w < way_count; ++w) {
+        if (way_ids[w] <= way_ids[w - 1]) return false;
+    }
+
+    for (uint32_t i = 0; i < extra_group_count; ++i) {
+        const uint32_t item = extra_groups[i].item;
+        if ((item & WAY_ITEM) ? (item & ~WAY_ITEM) >= way_count : item >= node_count) return false;
+    }
+    return true;
+}
+
+uint32_t MappedGeoBox::index_of(osmium::object_id_type node_id) const {
+    const uint32_t* first = node_by_id;
+    const uint32_t* last = node_by_id + node_count;
+    const uint32_t* it = std::lower_bound(first, last, node_id,
+        [this](uint32_t u, osmium::object_id_type id) { return node_ids[u] < id; });
+    return (it != last && node_ids[*it] == node_id) ? *it : INVALID_INDEX;
+}
+
+uint32_t MappedGeoBox::way_index_of(osmium::object_id_type way_id) const {
+    const osmium::object_id_type* last = way_ids + way_count;
+    const osmium::object_id_type* it = std::lower_bound(way_ids, last, way_id);
+    return (it != last && *it == way_id) ? static_cast<uint32_t>(it - way_ids) : INVALID_INDEX;
+}
+
+GeoBox MappedGeoBox::to_geobox() const {
+    GeoBox geo_box;
+    if (!is_open()) return geo_box;
+
+    MyData& data = geo_box.data;
+    data.nodes.reserve(node_count);
+    for (uint32_t u = 0; u < node_count; ++u) {
+        MyData::Point point(lats[u], lons[u], node_ids[u]);
+        point.incident_ways.assign(incident_ways + incident_offsets[u], incident_ways + incident_offsets[u + 1]);
+        point.groupes.insert_inline_mask(node_groups[u]);
+        point.objective_id = std::string(objective_id(u));
+        data.nodes.emplace(node_ids[u], std::move(point));
+    }
+
+    data.ways.reserve(way_count);
+    for (uint32_t w = 0; w < way_count; ++w) {
+        MyData::Way way(way_ids[w], way_node1_ids[w], way_node2_ids[w]);
+        way.distance_meters = way_distances[w];
+        way.groupes.insert_inline_mask(way_groups[w]);
+        data.ways.emplace(way_ids[w], std::move(way));
+    }
+
+    for (uint32_t i = 0; i < extra_group_count; ++i) {
+        const ExtraGroup& extra = extra_groups[i];
+        if (extra.item & WAY_ITEM) {
+            data.ways.at(way_ids[extra.item & ~WAY_ITEM]).groupes.insert(extra.group);
+        } else {
+            data.nodes.at(node_ids[extra.item]).groupes.insert(extra.group);
+        }
+    }
+
+    data.objective_groups = groups;
+    geo_box.bbox = box;
+    geo_box.source_file = source;
+    geo_box.is_valid = true;
+    return geo_box;
+}
@@ -0,0 +1,142 @@
+#ifndef MAPPED_GEOBOX_HPP
+#define MAPPED_GEOBOX_HPP
+
+#include "Box.hpp"
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Cache binaire d'une GeoBox (.gbx) et sa vue en lecture seule projetée en mémoire.
+// Le fichier est une suite de tableaux plats alignés sur 8 octets (ordre des octets natif) :
+// nodes dans l'ordre de Hilbert de RoadGraph (ids, coordonnées, positions 3D, masques de
+// groupes), adjacence CSR, ways triés par id, ways incidents et objective_id au format CSR.
+// open() valide l'en-tête puis, en un parcours linéaire, les offsets et indices des tableaux
+// (un fichier corrompu ne peut pas faire lire hors de la projection) : les requêtes
+// (index_of, parcours d'arêtes, A*) lisent ensuite directement le fichier, sans désérialisation.
+// to_geobox() reconstruit les unordered_map de MyData pour les traitements qui les modifient.
+class MappedGeoBox {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    MappedGeoBox() = default;
+
+    // Écriture atomique (fichier temporaire puis renommage)
+    static bool write(const GeoBox& geo_box, const std::string& filepath);
+
+    // Projection du fichier ; is_open() est faux s'il est absent, tronqué, incohérent ou d'une autre version
+    static MappedGeoBox open(const std::string& filepath);
+
+    // Le fichier commence-t-il par la signature du format binaire ?
+    static bool is_binary_cache(const std::string& filepath);
+
+    bool is_open() const { return file != nullptr; }
+
+    // Copie complète vers une GeoBox modifiable
+    GeoBox to_geobox() const;
+
+    const osmium::Box& bbox() const { return box; }
+    const std::string& source_file() const { return source; }
+    const std::unordered_map<int, ObjectiveGroup>& objective_groups() const { return groups; }
+
+    uint32_t num_nodes() const { return node_count; }
+    uint32_t num_edges() const { return edge_count; }
+    uint32_t num_ways() const { return way_count; }
+
+    // Nodes (indices 0..num_nodes() - 1, ordre de Hilbert)
+    uint32_t index_of(osmium::object_id_type node_id) const;
+    osmium::object_id_type node_id(uint32_t u) const { return node_ids[u]; }
+    double lat(uint32_t u) const { return lats[u]; }
+    double lon(uint32_t u) const { return lons[u]; }
+    uint64_t group_mask(uint32_t u) const { return node_groups[u]; }  // Groupes 0..63
+    std::string_view objective_id(uint32_t u) const {
+        return {objective_chars + objective_offsets[u], objective_offsets[u + 1] - objective_offsets[u]};
+    }
+
+    // Même minorant que RoadGraph::chord_distance
+    double chord_distance(uint32_t u, uint32_t v) const {
+        const double* a = positions + 3 * static_cast<size_t>(u);
+        const double* b = positions + 3 * static_cast<size_t>(v);
+        const double dx = a[0] - b[0];
+        const double dy = a[1] - b[1];
+        const double dz = a[2] - b[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    // Adjacence CSR (deux arêtes orientées par way valide, comme RoadGraph)
+    uint32_t edge_begin(uint32_t u) const { return edge_offsets[u]; }
+    uint32_t edge_end(uint32_t u) const { return edge_offsets[u + 1]; }
+    uint32_t degree(uint32_t u) const { return edge_offsets[u + 1] - edge_offsets[u]; }
+    uint32_t edge_target(uint32_t e) const { return edge_targets[e]; }
+    float edge_weight(uint32_t e) const { return edge_weights[e]; }
+    uint32_t edge_way(uint32_t e) const { return edge_ways[e]; }  // Indice du way
+
+    // Ways (indices 0..num_ways() - 1, ids croissants)
+    uint32_t way_index_of(osmium::object_id_type way_id) const;
+    osmium::object_id_type way_id(uint32_t w) const { return way_ids[w]; }
+    osmium::object_id_type way_node1_id(uint32_t w) const { return way_node1_ids[w]; }
+    osmium::object_id_type way_node2_id(uint32_t w) const { return way_node2_ids[w]; }
+    float way_distance(uint32_t w) const { return way_distances[w]; }
+    uint64_t way_group_mask(uint32_t w) const { return way_groups[w]; }  // Groupes 0..63
+
+    size_t file_bytes() const { return file ? file->size() : 0; }
+
+private:
+    // Groupe >= 64 d'un node (item = indice) ou d'un way (item = indice | WAY_ITEM)
+    struct ExtraGroup {
+        uint32_t item;
+        int32_t group;
+    };
+    static constexpr uint32_t WAY_ITEM = 0x80000000u;
+
+    std::shared_ptr<boost::iostreams::mapped_file_source> file;
+
+    uint32_t node_count = 0;
+    uint32_t edge_count = 0;
+    uint32_t way_count = 0;
+    uint32_t incident_count = 0;
+    uint32_t extra_group_count = 0;
+
+    const osmium::object_id_type* node_ids = nullptr;
+    const uint32_t* node_by_id = nullptr;  // Indices des nodes par id croissant
+    const double* lats = nullptr;
+    const double* lons = nullptr;
+    const double* positions = nullptr;  // x, y, z par node
+    const uint64_t* node_groups = nullptr;
+    const uint32_t* objective_offsets = nullptr;
+    const char* objective_chars = nullptr;
+    const uint32_t* incident_offsets = nullptr;
+    const osmium::object_id_type* incident_ways = nullptr;
+
+    const uint32_t* edge_offsets = nullptr;
+    const uint32_t* edge_targets = nullptr;
+    const float* edge_weights = nullptr;
+    const uint32_t* edge_ways = nullptr;
+
+    const osmium::object_id_type* way_ids = nullptr;
+    const osmium::object_id_type* way_node1_ids = nullptr;
+    const osmium::object_id_type* way_node2_ids = nullptr;
+    const float* way_distances = nullptr;
+    const uint64_t* way_groups = nullptr;
+
+    const ExtraGroup* extra_groups = nullptr;
+
+    // Métadonnées (petites, décodées à l'ouverture)
+    osmium::Box box;
+    std::string source;
+    bool valid_box = false;
+    std::unordered_map<int, ObjectiveGroup> groups;
+
+    bool read_metadata(const char* bytes, size_t size);
+
+    // Offsets CSR croissants, indices de nodes / ways dans les bornes, ids triés (recherches dichotomiques)
+    bool validate() const;
+};
+
+#endif // MAPPED_GEOBOX_HPP
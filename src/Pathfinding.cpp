@@ -1,11 +1,14 @@
 #include "Pathfinding.hpp"
+#include "AStar.hpp"
 #include "Box.hpp"
+#include "MappedGeoBox.hpp"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <unordered_map>
 #include <vector>
 #include <limits>
+#include <unordered_set>
 
 // Static member definition
 std::mutex Pathfinder::geobox_modification_mutex;
@@ -239,97 +242,172 @@ bool Pathfinder::Connected_subgraph_methode(
 
 std::vector<osmium::object_id_type> Pathfinder::A_Star_Search(
     const osmium::object_id_type& start_point,
-    const osmium::object_id_type& end_point) {
-    
-    std::vector<osmium::object_id_type> open = {start_point};
-
-    std::unordered_map<osmium::object_id_type, std::pair<osmium::object_id_type, osmium::object_id_type>> cameFrom;
-
-    std::unordered_map<osmium::object_id_type, float> GScore;
-    GScore[start_point] = 0.0f;
-
-    std::unordered_map<osmium::object_id_type, float> FScore;
-    FScore[start_point] = heuristic(start_point, end_point);
+    const osmium::object_id_type& end_point,
+    size_t* expanded_nodes) {
 
-    osmium::object_id_type actual_node = start_point;
-    osmium::object_id_type neighbor = start_point;
+    if (expanded_nodes) *expanded_nodes = 0;
 
-    float tentative_gScore = 0.0f;
+    // Un état de recherche par thread, réutilisé d'une requête à l'autre
+    thread_local SearchWorkspace workspace;
 
-    while (!open.empty()){
-
-        osmium::object_id_type actual_node = open[0];
-        size_t best_index = 0;
-        
-        for (size_t i = 1; i < open.size(); ++i) {
-            if (FScore.count(open[i]) && FScore.count(actual_node)) {
-                if (FScore[open[i]] < FScore[actual_node]) {
-                    actual_node = open[i];
-                    best_index = i;
-                }
-            }
+    // Projection du cache binaire : recherche directement dans le fichier
+    if (std::shared_ptr<const MappedGeoBox> mapped = mapped_graph()) {
+        const uint32_t start = mapped->index_of(start_point);
+        const uint32_t target = mapped->index_of(end_point);
+        if (start == MappedGeoBox::INVALID_INDEX || target == MappedGeoBox::INVALID_INDEX ||
+            !a_star_search(*mapped, workspace, start, target, expanded_nodes)) {
+            return {};
         }
 
-        if(actual_node == end_point){
-            return reconstruct_path(cameFrom, actual_node);
+        std::vector<osmium::object_id_type> way_path;
+        for (uint32_t e : a_star_edge_path(workspace, target)) {
+            way_path.push_back(mapped->way_id(mapped->edge_way(e)));
         }
+        return way_path;
+    }
 
-        open.erase(open.begin() + best_index);
-
-        for(const auto& way_id : geo_box.data.nodes[actual_node].incident_ways){
-            auto& way = geo_box.data.ways[way_id];
-            if(way.node1_id == actual_node){
-                neighbor = way.node2_id;
-            } else if(way.node2_id == actual_node) {
-                neighbor = way.node1_id;
-            } else {
-                continue; // Way struct Error
-            }
+    std::shared_ptr<const RoadGraph> snapshot = graph_for(start_point, end_point);
+    const RoadGraph& rg = *snapshot;
 
-            tentative_gScore = GScore[actual_node] + way.distance_meters;
-            if(!GScore.count(neighbor) || tentative_gScore < GScore[neighbor]){
-                cameFrom[neighbor] = std::make_pair(actual_node, way_id);
-                GScore[neighbor] = tentative_gScore;
-                FScore[neighbor] = tentative_gScore + heuristic(neighbor, end_point);
-                open.push_back(neighbor);
-            }
-        }
+    const uint32_t start = rg.index_of(start_point);
+    const uint32_t target = rg.index_of(end_point);
+    if (start == RoadGraph::INVALID_INDEX || target == RoadGraph::INVALID_INDEX ||
+        !a_star_search(rg, workspace, start, target, expanded_nodes)) {
+        return {};
     }
 
-    return {};
+    return reconstruct_path(rg, workspace, target);
 }
 
 std::vector<osmium::object_id_type> Pathfinder::reconstruct_path(
-    const std::unordered_map<osmium::object_id_type, std::pair<osmium::object_id_type, osmium::object_id_type>>& cameFrom,
-    osmium::object_id_type actual_node) {
+    const RoadGraph& road_graph,
+    const SearchWorkspace& workspace,
+    uint32_t actual_node) {
     
+    // Ordre start → end ; une arête contractée se déplie en ses ways d'origine
     std::vector<osmium::object_id_type> way_path;
-    
-    // Collecter les ways en ordre inverse
-    while(cameFrom.count(actual_node)) {
-        auto parent_node = cameFrom.at(actual_node).first;
-        auto way_id = cameFrom.at(actual_node).second;
-        
-        way_path.push_back(way_id);
-        actual_node = parent_node;
+    for (uint32_t e : a_star_edge_path(workspace, actual_node)) {
+        road_graph.append_edge_ways(e, way_path);
     }
     
-    // Inverser pour avoir l'ordre correct (start → end)
-    std::reverse(way_path.begin(), way_path.end());
-    
     return way_path;
 }
 
 float Pathfinder::heuristic(osmium::object_id_type act_node, osmium::object_id_type end_point) {
-    return 0.0f;
-
-    /*
-    // Heuristique haversine désactivée pour des performances optimales
-    // Peut être réactivée si nécessaire
-    auto& act_n = geo_box.data.nodes[act_node];
-    auto& tar_n = geo_box.data.nodes[end_point];
-    return calculate_haversine_distance(act_n.lat, act_n.lon, tar_n.lat, tar_n.lon);
-    */
+    std::shared_ptr<const RoadGraph> snapshot = graph_for(act_node, end_point);
+    const uint32_t u = snapshot->index_of(act_node);
+    const uint32_t v = snapshot->index_of(end_point);
+    if (u == RoadGraph::INVALID_INDEX || v == RoadGraph::INVALID_INDEX) {
+        return 0.0f;
+    }
+    return static_cast<float>(0.9999 * snapshot->chord_distance(u, v));
+}
+
+void Pathfinder::drop_stale_snapshots() {
+    if (snapshot_generation == geo_box.generation) return;
+    graph.reset();
+    full_graph.reset();
+    node_index.reset();
+    snapshot_generation = geo_box.generation;
+}
+
+std::shared_ptr<const RoadGraph> Pathfinder::road_graph() {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    drop_stale_snapshots();
+    if (!graph) {
+        graph = std::make_shared<const RoadGraph>(RoadGraph::build(geo_box.data, contract_chains));
+    }
+    return graph;
+}
+
+std::shared_ptr<const RoadGraph> Pathfinder::full_road_graph() {
+    {
+        std::lock_guard<std::mutex> lock(graph_mutex);
+        drop_stale_snapshots();
+        if (contract_chains) {
+            if (!full_graph) {
+                full_graph = std::make_shared<const RoadGraph>(RoadGraph::build(geo_box.data));
+            }
+            return full_graph;
+        }
+    }
+    return road_graph();
+}
+
+std::shared_ptr<const RoadGraph> Pathfinder::graph_for(osmium::object_id_type node1, osmium::object_id_type node2) {
+    std::shared_ptr<const RoadGraph> snapshot = road_graph();
+    if (snapshot->contracted() &&
+        (snapshot->index_of(node1) == RoadGraph::INVALID_INDEX ||
+         snapshot->index_of(node2) == RoadGraph::INVALID_INDEX)) {
+        return full_road_graph();
+    }
+    return snapshot;
+}
+
+bool Pathfinder::use_mapped_graph(std::shared_ptr<const MappedGeoBox> mapped_geo_box) {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    mapped.reset();
+    if (!mapped_geo_box || !mapped_geo_box->is_open() ||
+        mapped_geo_box->num_nodes() != geo_box.data.nodes.size() ||
+        mapped_geo_box->num_ways() != geo_box.data.ways.size()) {
+        return false;
+    }
+
+    // Identité : nodes et ways échantillonnés régulièrement (coût constant) retrouvés à l'identique
+    constexpr uint32_t SAMPLES = 64;
+    const MappedGeoBox& view = *mapped_geo_box;
+    for (uint32_t k = 0; k < SAMPLES && view.num_nodes() > 0; ++k) {
+        const uint32_t u = static_cast<uint32_t>(uint64_t(k) * view.num_nodes() / SAMPLES);
+        auto node_it = geo_box.data.nodes.find(view.node_id(u));
+        if (node_it == geo_box.data.nodes.end() || node_it->second.lat != view.lat(u)
+            || node_it->second.lon != view.lon(u)) {
+            return false;
+        }
+    }
+    for (uint32_t k = 0; k < SAMPLES && view.num_ways() > 0; ++k) {
+        const uint32_t w = static_cast<uint32_t>(uint64_t(k) * view.num_ways() / SAMPLES);
+        auto way_it = geo_box.data.ways.find(view.way_id(w));
+        if (way_it == geo_box.data.ways.end() || way_it->second.node1_id != view.way_node1_id(w)
+            || way_it->second.node2_id != view.way_node2_id(w)
+            || way_it->second.distance_meters != view.way_distance(w)) {
+            return false;
+        }
+    }
+
+    mapped = std::move(mapped_geo_box);
+    mapped_generation = geo_box.generation;
+    return true;
+}
+
+std::shared_ptr<const MappedGeoBox> Pathfinder::mapped_graph() {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    if (mapped && (contract_chains || mapped_generation != geo_box.generation)) {
+        mapped.reset();
+    }
+    return mapped;
+}
+
+void Pathfinder::set_chain_contraction(bool enable) {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    if (contract_chains == enable) return;
+    contract_chains = enable;
+    graph.reset();
+    full_graph.reset();
+}
+
+std::shared_ptr<const SpatialIndex> Pathfinder::spatial_index() {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    drop_stale_snapshots();
+    if (!node_index) {
+        node_index = std::make_shared<const SpatialIndex>(SpatialIndex::build(geo_box.data));
+    }
+    return node_index;
+}
+
+void Pathfinder::invalidate_graph() {
+    std::lock_guard<std::mutex> lock(graph_mutex);
+    geo_box.mark_modified();
+    drop_stale_snapshots();
 }
 
 // ====================================================================
@@ -351,6 +429,13 @@ double Pathfinder::calculate_distance(osmium::object_id_type node1, osmium::obje
 }
 
 osmium::object_id_type Pathfinder::find_nearest_node(double lat, double lon) {
-    // À implémenter si nécessaire
-    return 0;
+    return spatial_index()->nearest(lat, lon);
+}
+
+std::vector<SpatialIndex::Neighbor> Pathfinder::find_nearest_nodes(double lat, double lon, size_t k) {
+    return spatial_index()->k_nearest(lat, lon, k);
+}
+
+std::vector<SpatialIndex::Neighbor> Pathfinder::find_nodes_within(double lat, double lon, double radius_meters) {
+    return spatial_index()->within_radius(lat, lon, radius_meters);
 }
\ No newline at end of file
@@ -2,17 +2,49 @@
 #define PATHFINDING_HPP
 
 #include "Box.hpp"
+#include "RoadGraph.hpp"
+#include "SpatialIndex.hpp"
 #include "Common/Hashes.hpp"
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <mutex>
 
+class MappedGeoBox;
+
 // Classe principale pour le pathfinding
 class Pathfinder {
 private:
     static std::mutex geobox_modification_mutex;
 
+    // Instantané CSR du réseau, construit paresseusement à la première recherche
+    std::shared_ptr<const RoadGraph> graph;
+    std::mutex graph_mutex;
+
+    // Contraction des chaînes de degré 2 ; l'instantané complet n'est alors construit
+    // que si une recherche part d'un node retiré par la contraction
+    bool contract_chains = false;
+    std::shared_ptr<const RoadGraph> full_graph;
+
+    // Instantané contenant les deux nodes (contracté si possible, complet sinon)
+    std::shared_ptr<const RoadGraph> graph_for(osmium::object_id_type node1, osmium::object_id_type node2);
+
+    // Index spatial des nodes, construit paresseusement à la première requête de proximité
+    std::shared_ptr<const SpatialIndex> node_index;
+
+    // GeoBox::generation des instantanés ci-dessus ; s'il a changé, ils sont abandonnés
+    // (appelé sous graph_mutex)
+    uint64_t snapshot_generation = 0;
+    void drop_stale_snapshots();
+
+    // Projection du cache binaire dont la GeoBox a été chargée (voir use_mapped_graph)
+    std::shared_ptr<const MappedGeoBox> mapped;
+    uint64_t mapped_generation = 0;
+
+    // Projection utilisable pour A* : nulle si absente, si la GeoBox a été modifiée depuis
+    // ou si la contraction des chaînes est active
+    std::shared_ptr<const MappedGeoBox> mapped_graph();
+
 public:
     GeoBox& geo_box;
     explicit Pathfinder(GeoBox& box);
@@ -43,23 +75,52 @@ public:
     );
 
     // Algorithmes de recherche de chemin
+    // expanded_nodes (optionnel) reçoit le nombre de nodes développés
     std::vector<osmium::object_id_type> A_Star_Search(
         const osmium::object_id_type& start_point,
-        const osmium::object_id_type& end_point
+        const osmium::object_id_type& end_point,
+        size_t* expanded_nodes = nullptr
     );
 
     std::vector<osmium::object_id_type> reconstruct_path(
-        const std::unordered_map<osmium::object_id_type, std::pair<osmium::object_id_type, osmium::object_id_type>>& cameFrom,
-        osmium::object_id_type actual_node
+        const RoadGraph& road_graph,
+        const SearchWorkspace& workspace,
+        uint32_t actual_node
     );
 
     float heuristic(osmium::object_id_type act_node, osmium::object_id_type end_point);
+
+    // Instantané CSR partagé (thread-safe), contracté si set_chain_contraction(true)
+    std::shared_ptr<const RoadGraph> road_graph();
+
+    // Instantané sans contraction (identique à road_graph() si la contraction est désactivée)
+    std::shared_ptr<const RoadGraph> full_road_graph();
+
+    // Active la contraction des chaînes de degré 2 pour les recherches suivantes
+    void set_chain_contraction(bool enable);
+
+    // A_Star_Search lit le graphe directement dans la projection du cache .gbx d'où la GeoBox
+    // a été chargée, sans construire de RoadGraph (mêmes indices de Hilbert et même CSR, donc
+    // mêmes chemins). Abandonnée dès que la GeoBox est modifiée (GeoBox::generation) ;
+    // false si la projection est fermée ou ne correspond pas à la GeoBox (nombre de nodes et de
+    // ways, échantillon de nodes et de ways comparés à geo_box.data)
+    bool use_mapped_graph(std::shared_ptr<const MappedGeoBox> mapped_geo_box);
+
+    // Index spatial partagé (thread-safe), reconstruit si la GeoBox a été modifiée
+    // (GeoBox::generation)
+    std::shared_ptr<const SpatialIndex> spatial_index();
+
+    // Marque la GeoBox comme modifiée (GeoBox::mark_modified) : les instantanés CSR et
+    // l'index spatial de tous les Pathfinder qui la partagent seront reconstruits
+    void invalidate_graph();
     
     // Méthodes utilitaires
     void update_way_group(osmium::object_id_type way_id, int new_group);
     void update_way_group_threadsafe(osmium::object_id_type way_id, int new_group);
     double calculate_distance(osmium::object_id_type node1, osmium::object_id_type node2);
     osmium::object_id_type find_nearest_node(double lat, double lon);
+    std::vector<SpatialIndex::Neighbor> find_nearest_nodes(double lat, double lon, size_t k);
+    std::vector<SpatialIndex::Neighbor> find_nodes_within(double lat, double lon, double radius_meters);
 };
 
 #endif // PATHFINDING_HPP
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "PbfBlockIndex.hpp"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <osmium/io/pbf_input.hpp>
+#include <osmium/io/error.hpp>
+#include <osmium/osm/node.hpp>
+#include <osmium/osm/way.hpp>
+#include <protozero/pbf_reader.hpp>
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'P', 'B', 'F', 'I', 'D', 'X', '1', '\0'};
+
+// Limites du format PBF (BlobHeader < 64 Kio, Blob < 32 Mio)
+constexpr uint32_t MAX_BLOB_HEADER_SIZE = 64 * 1024;
+constexpr uint32_t MAX_BLOB_SIZE = 32 * 1024 * 1024;
+
+// Au-delà de cette fraction du fichier, l'extrait en mémoire coûte plus qu'il n'économise :
+// la lecture en flux du fichier complet est préférée
+constexpr uint64_t EXTRACT_MAX_FRACTION_DIVISOR = 2;
+
+struct RawBlob {
+    uint64_t offset = 0;
+    std::string type;
+    std::string bytes;  // Longueur + BlobHeader + Blob, tels que dans le fichier
+};
+
+enum class BlobRead {
+    OK,
+    END,     // Fin de fichier propre, entre deux blocs
+    INVALID  // Bloc tronqué, taille hors limites ou en-tête illisible
+};
+
+// Lecture du bloc suivant
+BlobRead read_raw_blob(std::ifstream& in, RawBlob& blob) {
+    blob.offset = static_cast<uint64_t>(in.tellg());
+
+    unsigned char size_bytes[4];
+    if (!in.read(reinterpret_cast<char*>(size_bytes), 4)) {
+        return in.gcount() == 0 && in.eof() ? BlobRead::END : BlobRead::INVALID;
+    }
+    const uint32_t header_size = (uint32_t(size_bytes[0]) << 24) | (uint32_t(size_bytes[1]) << 16) |
+                                 (uint32_t(size_bytes[2]) << 8) | uint32_t(size_bytes[3]);
+    if (header_size > MAX_BLOB_HEADER_SIZE) return BlobRead::INVALID;
+
+    std::string header(header_size, '\0');
+    if (!in.read(header.data(), header_size)) return BlobRead::INVALID;
+
+    blob.type.clear();
+    int32_t data_size = -1;
+    protozero::pbf_reader message(header);
+    while (message.next()) {
+        switch (message.tag()) {
+            case 1: blob.type = message.get_string(); break;
+            case 3: data_size = message.get_int32(); break;
+            default: message.skip(); break;
+        }
+    }
+    if (data_size < 0 || static_cast<uint32_t>(data_size) > MAX_BLOB_SIZE) return BlobRead::INVALID;
+
+    blob.bytes.resize(4 + header_size + static_cast<size_t>(data_size));
+    std::memcpy(blob.bytes.data(), size_bytes, 4);
+    std::memcpy(blob.bytes.data() + 4, header.data(), header_size);
+    return in.read(blob.bytes.data() + 4 + header_size, data_size) ? BlobRead::OK : BlobRead::INVALID;
+}
+
+int64_t file_mtime(const std::string& path) {
+    return static_cast<int64_t>(std::filesystem::last_write_time(path).time_since_epoch().count());
+}
+
+template <typename T>
+void write_pod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_pod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+std::pair<int, int> PbfBlockIndex::cell_of(const osmium::Location& location) const {
+    // Bornage en double avant la conversion : une emprise d'étendue nulle (en-tête réduit à
+    // un point ou à une ligne) donnerait NaN ou l'infini, non convertibles en int.
+    // Un axe dégénéré n'a qu'une colonne (ou ligne) utile : la cellule 0.
+    auto axis_cell = [](double value, double min, double max) {
+        const double extent = max - min;
+        if (!(extent > 0.0)) return 0;
+        const double cell = std::floor((value - min) / extent * GRID_SIZE);
+        if (!(cell > 0.0)) return 0;
+        return cell < GRID_SIZE - 1 ? static_cast<int>(cell) : GRID_SIZE - 1;
+    };
+
+    return {axis_cell(location.lon(), grid_box.bottom_left().lon(), grid_box.top_right().lon()),
+            axis_cell(location.lat(), grid_box.bottom_left().lat(), grid_box.top_right().lat())};
+}
+
+std::optional<PbfBlockIndex> PbfBlockIndex::build(const std::string& pbf_file) {
+    std::ifstream in(pbf_file, std::ios::binary);
+    if (!in) {
+        std::cerr << "Impossible d'ouvrir " << pbf_file << std::endl;
+        return std::nullopt;
+    }
+
+    PbfBlockIndex index;
+    index.source_size = static_cast<uint64_t>(std::filesystem::file_size(pbf_file));
+    index.source_mtime = file_mtime(pbf_file);
+
+    // Nodes triés par id (cas des extraits Geofabrik) : cellule de chaque node pour les ways
+    std::vector<osmium::object_id_type> node_ids;
+    std::vector<uint16_t> node_cells;
+    bool nodes_ordered = true;
+    bool ways_seen = false;
+
+    std::string header_bytes;
+    RawBlob blob;
+    BlobRead status;
+
+    try {
+        while ((status = read_raw_blob(in, blob)) == BlobRead::OK) {
+            Block block;
+            block.offset = blob.offset;
+            block.size = static_cast<uint32_t>(blob.bytes.size());
+
+            if (blob.type == "OSMHeader") {
+                block.kinds = HEADER;
+                header_bytes = blob.bytes;
+
+                osmium::io::Reader reader(osmium::io::File(header_bytes.data(), header_bytes.size(), "pbf"),
+                                          osmium::osm_entity_bits::nothing);
+                index.grid_box = reader.header().box();
+                reader.close();
+                if (!index.grid_box.valid()) {
+                    index.grid_box = osmium::Box(-180.0, -90.0, 180.0, 90.0);
+                }
+                index.blocks.push_back(block);
+                continue;
+            }
+
+            if (blob.type != "OSMData" || header_bytes.empty()) {
+                index.blocks.push_back(block);
+                continue;
+            }
+
+            // Le bloc est décodé seul, précédé de l'en-tête pour former un PBF valide
+            std::string single = header_bytes + blob.bytes;
+            osmium::io::Reader reader(osmium::io::File(single.data(), single.size(), "pbf"),
+                                      osmium::osm_entity_bits::node | osmium::osm_entity_bits::way,
+                                      osmium::io::read_meta::no);
+
+            auto mark = [&block](int x, int y) { block.cells[y] |= uint64_t(1) << x; };
+
+            while (osmium::memory::Buffer buffer = reader.read()) {
+                for (const auto& item : buffer) {
+                    if (item.type() == osmium::item_type::node) {
+                        const auto& node = static_cast<const osmium::Node&>(item);
+                        block.kinds |= NODES;
+                        if (ways_seen || (!node_ids.empty() && node.id() <= node_ids.back())) {
+                            nodes_ordered = false;
+                        }
+                        if (!node.location().valid()) continue;
+
+                        auto [x, y] = index.cell_of(node.location());
+                        mark(x, y);
+                        node_ids.push_back(node.id());
+                        node_cells.push_back(static_cast<uint16_t>(y * GRID_SIZE + x));
+
+                    } else if (item.type() == osmium::item_type::way) {
+                        const auto& way = static_cast<const osmium::Way&>(item);
+                        block.kinds |= WAYS;
+                        ways_seen = true;
+                        if (!nodes_ordered) continue;
+
+                        for (const auto& node_ref : way.nodes()) {
+                            auto it = std::lower_bound(node_ids.begin(), node_ids.end(), node_ref.ref());
+                            if (it == node_ids.end() || *it != node_ref.ref()) continue;
+                            uint16_t cell = node_cells[it - node_ids.begin()];
+                            mark(cell % GRID_SIZE, cell / GRID_SIZE);
+                        }
+                    }
+                }
+            }
+            reader.close();
+
+            if (block.kinds == 0) block.kinds = RELATIONS;
+            index.blocks.push_back(block);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur lors de l'indexation de " << pbf_file << ": " << e.what() << std::endl;
+        return std::nullopt;
+    }
+
+    // Un index partiel ferait ignorer silencieusement la fin du fichier
+    if (status == BlobRead::INVALID) {
+        std::cerr << "Bloc tronqué ou invalide à l'offset " << blob.offset << " de " << pbf_file << std::endl;
+        return std::nullopt;
+    }
+
+    if (header_bytes.empty()) {
+        std::cerr << "Pas d'en-tête OSMHeader dans " << pbf_file << std::endl;
+        return std::nullopt;
+    }
+
+    // Nodes non triés : les ways ne peuvent pas être situés, on les garde toujours
+    if (!nodes_ordered) {
+        std::cout << "Nodes non triés par id : blocs de ways conservés pour toutes les bbox" << std::endl;
+        for (auto& block : index.blocks) {
+            if (block.kinds & WAYS) block.cells.fill(~uint64_t(0));
+        }
+    }
+
+    std::cout << "Index PBF : " << index.blocks.size() << " blocs, "
+              << node_ids.size() << " nodes" << std::endl;
+    return index;
+}
+
+bool PbfBlockIndex::save(const std::string& index_file) const {
+    std::ofstream out(index_file, std::ios::binary);
+    if (!out) {
+        std::cerr << "Impossible d'écrire " << index_file << std::endl;
+        return false;
+    }
+
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    write_pod(out, source_size);
+    write_pod(out, source_mtime);
+    write_pod(out, grid_box.bottom_left().lon());
+    write_pod(out, grid_box.bottom_left().lat());
+    write_pod(out, grid_box.top_right().lon());
+    write_pod(out, grid_box.top_right().lat());
+    write_pod(out, static_cast<uint64_t>(blocks.size()));
+
+    for (const auto& block : blocks) {
+        write_pod(out, block.offset);
+        write_pod(out, block.size);
+        write_pod(out, block.kinds);
+        out.write(reinterpret_cast<const char*>(block.cells.data()), sizeof(block.cells));
+    }
+
+    return static_cast<bool>(out);
+}
+
+std::optional<PbfBlockIndex> PbfBlockIndex::load(const std::string& index_file, const std::string& pbf_file) {
+    if (!std::filesystem::exists(index_file) || !std::filesystem::exists(pbf_file)) {
+        return std::nullopt;
+    }
+
+    std::ifstream in(index_file, std::ios::binary);
+    char magic[sizeof(INDEX_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "Index PBF invalide: " << index_file << std::endl;
+        return std::nullopt;
+    }
+
+    PbfBlockIndex index;
+    double min_lon, min_lat, max_lon, max_lat;
+    uint64_t count = 0;
+    if (!read_pod(in, index.source_size) || !read_pod(in, index.source_mtime) ||
+        !read_pod(in, min_lon) || !read_pod(in, min_lat) ||
+        !read_pod(in, max_lon) || !read_pod(in, max_lat) || !read_pod(in, count)) {
+        return std::nullopt;
+    }
+
+    if (index.source_size != std::filesystem::file_size(pbf_file) ||
+        index.source_mtime != file_mtime(pbf_file)) {
+        std::cout << "Index PBF périmé, lecture complète de " << pbf_file << std::endl;
+        return std::nullopt;
+    }
+
+    index.grid_box = osmium::Box(min_lon, min_lat, max_lon, max_lat);
+    index.blocks.resize(count);
+    for (auto& block : index.blocks) {
+        if (!read_pod(in, block.offset) || !read_pod(in, block.size) || !read_pod(in, block.kinds) ||
+            !in.read(reinterpret_cast<char*>(block.cells.data()), sizeof(block.cells))) {
+            std::cerr << "Index PBF tronqué: " << index_file << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    return index;
+}
+
+std::string PbfBlockIndex::extract(const std::string& pbf_file, const std::vector<osmium::Box>& bboxes) const {
+    // Masque des cellules couvertes par au moins une bbox
+    std::array<uint64_t, GRID_SIZE> wanted{};
+    for (const auto& bbox : bboxes) {
+        auto [x_min, y_min] = cell_of(bbox.bottom_left());
+        auto [x_max, y_max] = cell_of(bbox.top_right());
+
+        uint64_t row_mask = 0;
+        for (int x = x_min; x <= x_max; ++x) row_mask |= uint64_t(1) << x;
+        for (int y = y_min; y <= y_max; ++y) wanted[y] |= row_mask;
+    }
+
+    std::vector<const Block*> kept;
+    uint64_t kept_bytes = 0;
+    for (const auto& block : blocks) {
+        bool keep = (block.kinds & HEADER) != 0;
+        if (!keep && (block.kinds & (NODES | WAYS))) {
+            for (int y = 0; y < GRID_SIZE && !keep; ++y) {
+                keep = (block.cells[y] & wanted[y]) != 0;
+            }
+        }
+        if (!keep) continue;
+        kept.push_back(&block);
+        kept_bytes += block.size;
+    }
+
+    // Sélection trop large : la copie en mémoire doublerait presque le fichier sans gain de lecture
+    if (kept_bytes > source_size / EXTRACT_MAX_FRACTION_DIVISOR) {
+        std::cout << "Index PBF : " << kept.size() << "/" << blocks.size()
+                  << " blocs retenus, lecture en flux du fichier complet" << std::endl;
+        return {};
+    }
+
+    std::ifstream in(pbf_file, std::ios::binary);
+    if (!in) return {};
+
+    std::string result;
+    result.reserve(static_cast<size_t>(kept_bytes));
+    for (const Block* block : kept) {
+        const size_t start = result.size();
+        result.resize(start + block->size);
+        in.seekg(static_cast<std::streamoff>(block->offset));
+        if (!in.read(result.data() + start, block->size)) return {};
+    }
+
+    std::cout << "Index PBF : " << kept.size() << "/" << blocks.size() << " blocs retenus ("
+              << result.size() / (1024 * 1024) << " Mio)" << std::endl;
+    return result;
+}
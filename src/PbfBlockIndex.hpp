@@ -0,0 +1,62 @@
+#ifndef PBF_BLOCK_INDEX_HPP
+#define PBF_BLOCK_INDEX_HPP
+
+#include <osmium/osm/box.hpp>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Index spatial des blocs (blobs) d'un fichier PBF, stocké à côté du fichier (<pbf>.blkidx).
+// Chaque bloc est résumé par une grille d'occupation GRID_SIZE x GRID_SIZE sur l'emprise
+// du fichier : cellules contenant un de ses nodes, ou un node référencé par un de ses ways.
+// create_geo_box ne décode alors que l'en-tête et les blocs touchant la ou les bbox demandées.
+class PbfBlockIndex {
+public:
+    static constexpr int GRID_SIZE = 64;
+
+    enum BlockKind : uint8_t {
+        HEADER = 1,
+        NODES = 2,
+        WAYS = 4,
+        RELATIONS = 8
+    };
+
+    struct Block {
+        uint64_t offset = 0;  // Début du bloc (longueur de l'en-tête incluse)
+        uint32_t size = 0;    // Taille totale du bloc en octets
+        uint8_t kinds = 0;    // Combinaison de BlockKind
+        std::array<uint64_t, GRID_SIZE> cells{};  // cells[y] bit x : cellule (x, y) touchée
+    };
+
+    PbfBlockIndex() = default;
+
+    // Lecture complète du fichier, chaque bloc étant décodé une fois (outil ponctuel).
+    // Mémoire : ~10 octets par node pour situer les nodes référencés par les ways.
+    static std::optional<PbfBlockIndex> build(const std::string& pbf_file);
+
+    bool save(const std::string& index_file) const;
+
+    // nullopt si l'index est absent, illisible ou périmé (taille ou date du PBF modifiées)
+    static std::optional<PbfBlockIndex> load(const std::string& index_file, const std::string& pbf_file);
+
+    static std::string index_path(const std::string& pbf_file) { return pbf_file + ".blkidx"; }
+
+    // PBF réduit en mémoire : en-tête suivi des blocs de nodes/ways touchant une des bbox.
+    // Chaîne vide (lecture complète en flux) si ces blocs dépassent la moitié du fichier.
+    std::string extract(const std::string& pbf_file, const std::vector<osmium::Box>& bboxes) const;
+
+    size_t size() const { return blocks.size(); }
+
+private:
+    osmium::Box grid_box;  // Emprise de la grille (bbox de l'en-tête, sinon le monde)
+    uint64_t source_size = 0;
+    int64_t source_mtime = 0;
+    std::vector<Block> blocks;
+
+    // Cellule (x, y) d'une position, bornée à la grille
+    std::pair<int, int> cell_of(const osmium::Location& location) const;
+};
+
+#endif // PBF_BLOCK_INDEX_HPP
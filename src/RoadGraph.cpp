@@ -0,0 +1,290 @@
+#include "RoadGraph.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Rang du point (x, y) sur la courbe de Hilbert d'une grille 2^16 x 2^16
+uint64_t hilbert_index(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1u : 0u;
+        const uint32_t ry = (y & s) ? 1u : 0u;
+        d += static_cast<uint64_t>(s) * s * ((3u * rx) ^ ry);
+        // Rotation du quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Ids des nodes triés selon la courbe de Hilbert sur l'emprise (lat, lon) des données,
+// départagés par id pour un ordre déterministe
+std::vector<osmium::object_id_type> hilbert_sorted_ids(const MyData& data) {
+    double min_lat = std::numeric_limits<double>::max();
+    double min_lon = std::numeric_limits<double>::max();
+    double max_lat = std::numeric_limits<double>::lowest();
+    double max_lon = std::numeric_limits<double>::lowest();
+    for (const auto& [node_id, point] : data.nodes) {
+        min_lat = std::min(min_lat, point.lat);
+        min_lon = std::min(min_lon, point.lon);
+        max_lat = std::max(max_lat, point.lat);
+        max_lon = std::max(max_lon, point.lon);
+    }
+
+    constexpr double GRID_MAX = 65535.0;
+    const double lat_scale = (max_lat > min_lat) ? GRID_MAX / (max_lat - min_lat) : 0.0;
+    const double lon_scale = (max_lon > min_lon) ? GRID_MAX / (max_lon - min_lon) : 0.0;
+
+    std::vector<std::pair<uint64_t, osmium::object_id_type>> keyed;
+    keyed.reserve(data.nodes.size());
+    for (const auto& [node_id, point] : data.nodes) {
+        const auto x = static_cast<uint32_t>((point.lon - min_lon) * lon_scale);
+        const auto y = static_cast<uint32_t>((point.lat - min_lat) * lat_scale);
+        keyed.emplace_back(hilbert_index(x, y), node_id);
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<osmium::object_id_type> ids;
+    ids.reserve(keyed.size());
+    for (const auto& [key, node_id] : keyed) {
+        ids.push_back(node_id);
+    }
+    return ids;
+}
+
+} // namespace
+
+RoadGraph RoadGraph::build(const MyData& data, bool contract_chains, NodeOrder order) {
+    RoadGraph graph;
+
+    // 1. Indices denses dans un ordre déterministe (ids OSM ou courbe de Hilbert)
+    if (order == NodeOrder::Hilbert) {
+        graph.node_ids = hilbert_sorted_ids(data);
+    } else {
+        graph.node_ids.reserve(data.nodes.size());
+        for (const auto& [node_id, point] : data.nodes) {
+            graph.node_ids.push_back(node_id);
+        }
+        std::sort(graph.node_ids.begin(), graph.node_ids.end());
+    }
+
+    const uint32_t n = static_cast<uint32_t>(graph.node_ids.size());
+    graph.id_to_index.reserve(n);
+    graph.lats.resize(n);
+    graph.lons.resize(n);
+    graph.positions.resize(n);
+    graph.group_masks.resize(n);
+
+    const double R = 6371000.0;
+    const double deg_to_rad = 3.14159265358979323846 / 180.0;
+
+    for (uint32_t u = 0; u < n; ++u) {
+        const auto& point = data.nodes.at(graph.node_ids[u]);
+        graph.id_to_index[graph.node_ids[u]] = u;
+        graph.lats[u] = point.lat;
+        graph.lons[u] = point.lon;
+        graph.group_masks[u] = point.groupes.inline_mask();
+
+        const double lat = point.lat * deg_to_rad;
+        const double lon = point.lon * deg_to_rad;
+        graph.positions[u] = {
+            R * std::cos(lat) * std::cos(lon),
+            R * std::cos(lat) * std::sin(lon),
+            R * std::sin(lat)
+        };
+    }
+
+    // 2. Ways valides, triées par id pour un ordre d'adjacence stable
+    struct RawEdge {
+        osmium::object_id_type way_id;
+        uint32_t u;
+        uint32_t v;
+        float weight;
+    };
+
+    std::vector<RawEdge> raw_edges;
+    raw_edges.reserve(data.ways.size());
+    for (const auto& [way_id, way] : data.ways) {
+        uint32_t u = graph.index_of(way.node1_id);
+        uint32_t v = graph.index_of(way.node2_id);
+        if (u == INVALID_INDEX || v == INVALID_INDEX || u == v) continue;
+        raw_edges.push_back({way_id, u, v, way.distance_meters});
+    }
+    std::sort(raw_edges.begin(), raw_edges.end(),
+              [](const RawEdge& a, const RawEdge& b) { return a.way_id < b.way_id; });
+
+    // 3. CSR par tri comptage (deux arêtes orientées par way)
+    graph.offsets.assign(n + 1, 0);
+    for (const auto& edge : raw_edges) {
+        graph.offsets[edge.u + 1]++;
+        graph.offsets[edge.v + 1]++;
+    }
+    for (uint32_t u = 0; u < n; ++u) {
+        graph.offsets[u + 1] += graph.offsets[u];
+    }
+
+    const size_t m = graph.offsets[n];
+    graph.targets.resize(m);
+    graph.weights.resize(m);
+    graph.way_ids.resize(m);
+
+    std::vector<uint32_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto& edge : raw_edges) {
+        uint32_t e = cursor[edge.u]++;
+        graph.targets[e] = edge.v;
+        graph.weights[e] = edge.weight;
+        graph.way_ids[e] = edge.way_id;
+
+        e = cursor[edge.v]++;
+        graph.targets[e] = edge.u;
+        graph.weights[e] = edge.weight;
+        graph.way_ids[e] = edge.way_id;
+    }
+
+    return contract_chains ? graph.contract(data) : graph;
+}
+
+RoadGraph RoadGraph::contract(const MyData& data) const {
+    const uint32_t n = num_nodes();
+
+    // 1. Nodes conservés : degré != 2, deux arêtes vers le même voisin, ou objectif
+    std::vector<char> keep(n, 0);
+    for (uint32_t u = 0; u < n; ++u) {
+        const auto& point = data.nodes.at(node_ids[u]);
+        keep[u] = degree(u) != 2
+               || targets[offsets[u]] == targets[offsets[u] + 1]
+               || !point.groupes.empty()
+               || !point.objective_id.empty();
+    }
+
+    RoadGraph graph;
+    std::vector<uint32_t> new_index(n, INVALID_INDEX);
+    for (uint32_t u = 0; u < n; ++u) {
+        if (!keep[u]) continue;
+        new_index[u] = static_cast<uint32_t>(graph.node_ids.size());
+        graph.node_ids.push_back(node_ids[u]);
+        graph.id_to_index[node_ids[u]] = new_index[u];
+        graph.lats.push_back(lats[u]);
+        graph.lons.push_back(lons[u]);
+        graph.positions.push_back(positions[u]);
+        graph.group_masks.push_back(group_masks[u]);
+    }
+
+    // 2. Chaînes : depuis chaque node conservé, suivre chaque arête jusqu'au prochain
+    // node conservé. Chaque chaîne est vue depuis ses deux extrémités ; elle n'est gardée
+    // que depuis la plus petite (ou, pour une boucle, dans le sens où son premier way
+    // est le plus petit)
+    struct RawChain {
+        uint32_t u;
+        uint32_t v;
+        float weight;
+    };
+    std::vector<RawChain> chains;
+    graph.chain_offsets.push_back(0);
+
+    std::vector<osmium::object_id_type> ways;
+    for (uint32_t u = 0; u < n; ++u) {
+        if (!keep[u]) continue;
+
+        for (uint32_t e = edge_begin(u); e < edge_end(u); ++e) {
+            ways.assign(1, way_ids[e]);
+            double weight = weights[e];
+            uint32_t previous = u;
+            uint32_t current = targets[e];
+
+            while (!keep[current]) {
+                // Node de degré 2 à deux voisins distincts : l'arête qui ne revient pas en arrière
+                uint32_t next = offsets[current];
+                if (targets[next] == previous) ++next;
+                ways.push_back(way_ids[next]);
+                weight += weights[next];
+                previous = current;
+                current = targets[next];
+            }
+
+            const uint32_t v = current;
+            if (v < u || (v == u && ways.front() > ways.back())) continue;
+
+            chains.push_back({new_index[u], new_index[v], static_cast<float>(weight)});
+            graph.chain_ways.insert(graph.chain_ways.end(), ways.begin(), ways.end());
+            graph.chain_offsets.push_back(static_cast<uint32_t>(graph.chain_ways.size()));
+        }
+    }
+
+    // 3. CSR : deux arêtes orientées par chaîne, l'arête v -> u la parcourt à l'envers
+    const uint32_t kept = graph.num_nodes();
+    graph.offsets.assign(kept + 1, 0);
+    for (const auto& chain : chains) {
+        graph.offsets[chain.u + 1]++;
+        graph.offsets[chain.v + 1]++;
+    }
+    for (uint32_t u = 0; u < kept; ++u) {
+        graph.offsets[u + 1] += graph.offsets[u];
+    }
+
+    const size_t m = graph.offsets[kept];
+    graph.targets.resize(m);
+    graph.weights.resize(m);
+    graph.way_ids.resize(m);
+    graph.edge_chains.resize(m);
+
+    std::vector<uint32_t> cursor(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (uint32_t c = 0; c < chains.size(); ++c) {
+        const auto& chain = chains[c];
+        const uint32_t first = graph.chain_offsets[c];
+        const uint32_t last = graph.chain_offsets[c + 1] - 1;
+
+        uint32_t e = cursor[chain.u]++;
+        graph.targets[e] = chain.v;
+        graph.weights[e] = chain.weight;
+        graph.way_ids[e] = graph.chain_ways[first];
+        graph.edge_chains[e] = c << 1;
+
+        e = cursor[chain.v]++;
+        graph.targets[e] = chain.u;
+        graph.weights[e] = chain.weight;
+        graph.way_ids[e] = graph.chain_ways[last];
+        graph.edge_chains[e] = (c << 1) | 1u;
+    }
+
+    return graph;
+}
+
+void RoadGraph::append_edge_ways(uint32_t e, std::vector<osmium::object_id_type>& out, bool reversed) const {
+    if (!contracted()) {
+        out.push_back(way_ids[e]);
+        return;
+    }
+
+    const uint32_t chain = edge_chains[e] >> 1;
+    const bool backward = ((edge_chains[e] & 1u) != 0) != reversed;
+    const auto first = chain_ways.begin() + chain_offsets[chain];
+    const auto last = chain_ways.begin() + chain_offsets[chain + 1];
+
+    if (backward) {
+        out.insert(out.end(), std::make_reverse_iterator(last), std::make_reverse_iterator(first));
+    } else {
+        out.insert(out.end(), first, last);
+    }
+}
+
+size_t RoadGraph::memory_bytes() const {
+    return node_ids.capacity() * sizeof(osmium::object_id_type)
+         + lats.capacity() * sizeof(double)
+         + lons.capacity() * sizeof(double)
+         + positions.capacity() * sizeof(std::array<double, 3>)
+         + group_masks.capacity() * sizeof(uint64_t)
+         + offsets.capacity() * sizeof(uint32_t)
+         + targets.capacity() * sizeof(uint32_t)
+         + weights.capacity() * sizeof(float)
+         + way_ids.capacity() * sizeof(osmium::object_id_type)
+         + edge_chains.capacity() * sizeof(uint32_t)
+         + chain_offsets.capacity() * sizeof(uint32_t)
+         + chain_ways.capacity() * sizeof(osmium::object_id_type);
+}
@@ -0,0 +1,141 @@
+#ifndef ROAD_GRAPH_HPP
+#define ROAD_GRAPH_HPP
+
+#include "Box.hpp"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Instantané compact du réseau routier construit une fois depuis GeoBox::data.
+// Les ids OSM sont renumérotés en indices denses 32 bits et l'adjacence est
+// stockée au format CSR : les arêtes sortantes du node u occupent
+// [offsets[u], offsets[u + 1]) dans les tableaux targets / weights / way_ids.
+// Chaque way MyData (non orienté) produit deux arêtes orientées.
+// Par défaut les indices suivent une courbe de Hilbert sur (lat, lon) : des nodes
+// proches sur le terrain sont proches dans les tableaux, et comme les arêtes sont
+// rangées par node source, un parcours local lit la mémoire presque séquentiellement.
+class RoadGraph {
+public:
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    // Numérotation des nodes : ids OSM croissants, ou ordre de la courbe de Hilbert
+    enum class NodeOrder { ById, Hilbert };
+
+    RoadGraph() = default;
+
+    // Construire l'instantané depuis les données d'une GeoBox.
+    // contract_chains : chaque chaîne maximale de nodes de degré 2 sans objectif (ni groupe
+    // ni objective_id) devient une seule arête pondérée par la somme de ses segments ;
+    // les ways d'origine restent accessibles via append_edge_ways
+    static RoadGraph build(const MyData& data, bool contract_chains = false,
+                           NodeOrder order = NodeOrder::Hilbert);
+
+    uint32_t num_nodes() const { return static_cast<uint32_t>(node_ids.size()); }
+    uint32_t num_edges() const { return static_cast<uint32_t>(targets.size()); }
+    bool empty() const { return node_ids.empty(); }
+
+    // Correspondance id OSM <-> indice dense
+    uint32_t index_of(osmium::object_id_type node_id) const {
+        auto it = id_to_index.find(node_id);
+        return (it != id_to_index.end()) ? it->second : INVALID_INDEX;
+    }
+    osmium::object_id_type node_id(uint32_t u) const { return node_ids[u]; }
+
+    // Coordonnées
+    double lat(uint32_t u) const { return lats[u]; }
+    double lon(uint32_t u) const { return lons[u]; }
+
+    // Groupes 0..63 du node (bit g = groupe g), voir GroupSet::inline_mask
+    uint64_t group_mask(uint32_t u) const { return group_masks[u]; }
+
+    // Position 3D (mètres, centre de la Terre à l'origine)
+    const std::array<double, 3>& position(uint32_t u) const { return positions[u]; }
+
+    // Distance en corde 3D sur la sphère terrestre : toujours <= distance haversine,
+    // donc minorant admissible de toute longueur de chemin routier
+    double chord_distance(uint32_t u, uint32_t v) const {
+        const auto& a = positions[u];
+        const auto& b = positions[v];
+        const double dx = a[0] - b[0];
+        const double dy = a[1] - b[1];
+        const double dz = a[2] - b[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    // Adjacence CSR
+    uint32_t edge_begin(uint32_t u) const { return offsets[u]; }
+    uint32_t edge_end(uint32_t u) const { return offsets[u + 1]; }
+    uint32_t degree(uint32_t u) const { return offsets[u + 1] - offsets[u]; }
+    uint32_t edge_target(uint32_t e) const { return targets[e]; }
+    float edge_weight(uint32_t e) const { return weights[e]; }
+    // Premier way MyData parcouru par l'arête (le seul hors contraction)
+    osmium::object_id_type edge_way_id(uint32_t e) const { return way_ids[e]; }
+
+    bool contracted() const { return !chain_offsets.empty(); }
+
+    // Ajoute à out les ways MyData parcourus par l'arête e, dans le sens de parcours
+    // (ou dans le sens inverse si reversed)
+    void append_edge_ways(uint32_t e, std::vector<osmium::object_id_type>& out, bool reversed = false) const;
+
+    // Empreinte mémoire approximative des tableaux (octets)
+    size_t memory_bytes() const;
+
+private:
+    std::vector<osmium::object_id_type> node_ids;
+    std::unordered_map<osmium::object_id_type, uint32_t> id_to_index;
+    std::vector<double> lats;
+    std::vector<double> lons;
+    std::vector<std::array<double, 3>> positions;
+    std::vector<uint64_t> group_masks;
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<float> weights;
+    std::vector<osmium::object_id_type> way_ids;
+
+    // Graphe contracté : par arête orientée (chaîne << 1) | parcours inversé, et ways de
+    // chaque chaîne au format CSR [chain_offsets[c], chain_offsets[c + 1])
+    std::vector<uint32_t> edge_chains;
+    std::vector<uint32_t> chain_offsets;
+    std::vector<osmium::object_id_type> chain_ways;
+
+    RoadGraph contract(const MyData& data) const;
+};
+
+// État de recherche réutilisable (une instance par thread) : les tableaux
+// sont dimensionnés une fois et « remis à zéro » en O(1) par tamponnage de génération
+struct SearchWorkspace {
+    std::vector<float> g_score;
+    std::vector<uint32_t> parent_node;
+    std::vector<uint32_t> parent_edge;
+    std::vector<uint32_t> seen_stamp;
+    std::vector<uint32_t> closed_stamp;
+    uint32_t generation = 0;
+
+    void prepare(uint32_t num_nodes) {
+        if (seen_stamp.size() != num_nodes) {
+            g_score.assign(num_nodes, 0.0f);
+            parent_node.assign(num_nodes, RoadGraph::INVALID_INDEX);
+            parent_edge.assign(num_nodes, RoadGraph::INVALID_INDEX);
+            seen_stamp.assign(num_nodes, 0);
+            closed_stamp.assign(num_nodes, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            std::fill(seen_stamp.begin(), seen_stamp.end(), 0);
+            std::fill(closed_stamp.begin(), closed_stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    bool seen(uint32_t u) const { return seen_stamp[u] == generation; }
+    bool closed(uint32_t u) const { return closed_stamp[u] == generation; }
+    void mark_seen(uint32_t u) { seen_stamp[u] = generation; }
+    void mark_closed(uint32_t u) { closed_stamp[u] = generation; }
+};
+
+#endif // ROAD_GRAPH_HPP
@@ -0,0 +1,217 @@
+#include "SpatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double EARTH_RADIUS = 6371000.0;
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+} // namespace
+
+std::pair<double, double> SpatialIndex::project(double lat, double lon) const {
+    return {lon * DEG_TO_RAD * EARTH_RADIUS * cos_ref, lat * DEG_TO_RAD * EARTH_RADIUS};
+}
+
+int SpatialIndex::clamp_col(double x) const {
+    return std::clamp(static_cast<int>(std::floor((x - min_x) / cell_size)), 0, cols - 1);
+}
+
+int SpatialIndex::clamp_row(double y) const {
+    return std::clamp(static_cast<int>(std::floor((y - min_y) / cell_size)), 0, rows - 1);
+}
+
+SpatialIndex SpatialIndex::build(const MyData& data, double nodes_per_cell) {
+    std::vector<Entry> entries;
+    entries.reserve(data.nodes.size());
+    for (const auto& [node_id, point] : data.nodes) {
+        entries.push_back(Entry{node_id, point.lat, point.lon});
+    }
+    return from_entries(std::move(entries), nodes_per_cell);
+}
+
+SpatialIndex SpatialIndex::build(const MyData& data, const std::vector<osmium::object_id_type>& node_ids,
+                                 double nodes_per_cell) {
+    std::vector<Entry> entries;
+    entries.reserve(node_ids.size());
+    for (osmium::object_id_type node_id : node_ids) {
+        auto it = data.nodes.find(node_id);
+        if (it == data.nodes.end()) continue;
+        entries.push_back(Entry{node_id, it->second.lat, it->second.lon});
+    }
+    return from_entries(std::move(entries), nodes_per_cell);
+}
+
+SpatialIndex SpatialIndex::from_entries(std::vector<Entry> entries, double nodes_per_cell) {
+    SpatialIndex index;
+    if (entries.empty()) return index;
+
+    double min_lat = std::numeric_limits<double>::max();
+    double max_lat = std::numeric_limits<double>::lowest();
+    for (const Entry& entry : entries) {
+        min_lat = std::min(min_lat, entry.lat);
+        max_lat = std::max(max_lat, entry.lat);
+    }
+
+    // Projection centrée sur la latitude moyenne ; la distance projetée est-ouest
+    // surestime au plus la vraie d'un facteur cos_ref / cos(lat) sur l'emprise
+    index.cos_ref = std::cos(0.5 * (min_lat + max_lat) * DEG_TO_RAD);
+    const double cos_far = std::cos(std::max(std::abs(min_lat), std::abs(max_lat)) * DEG_TO_RAD);
+    index.scale_floor = 0.999 * std::min(1.0, cos_far / index.cos_ref);
+
+    double max_x = std::numeric_limits<double>::lowest();
+    double max_y = std::numeric_limits<double>::lowest();
+    index.min_x = std::numeric_limits<double>::max();
+    index.min_y = std::numeric_limits<double>::max();
+
+    std::vector<std::pair<double, double>> projected;
+    projected.reserve(entries.size());
+
+    for (const Entry& entry : entries) {
+        auto [x, y] = index.project(entry.lat, entry.lon);
+        index.min_x = std::min(index.min_x, x);
+        index.min_y = std::min(index.min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+        projected.emplace_back(x, y);
+    }
+    index.entries = std::move(entries);
+
+    // Cellules dimensionnées pour ~nodes_per_cell nodes en moyenne
+    const double width = std::max(max_x - index.min_x, 1.0);
+    const double height = std::max(max_y - index.min_y, 1.0);
+    const double n = static_cast<double>(index.entries.size());
+    index.cell_size = std::max(std::sqrt(width * height * nodes_per_cell / n), 1.0);
+    index.cols = static_cast<int>(width / index.cell_size) + 1;
+    index.rows = static_cast<int>(height / index.cell_size) + 1;
+
+    // Tri par comptage des nodes selon leur cellule
+    const size_t num_cells = static_cast<size_t>(index.cols) * index.rows;
+    std::vector<uint32_t> cell_of(index.entries.size());
+    index.cell_start.assign(num_cells + 1, 0);
+
+    for (size_t i = 0; i < projected.size(); ++i) {
+        const auto [x, y] = projected[i];
+        cell_of[i] = static_cast<uint32_t>(index.clamp_row(y) * index.cols + index.clamp_col(x));
+        index.cell_start[cell_of[i] + 1]++;
+    }
+    for (size_t c = 0; c < num_cells; ++c) {
+        index.cell_start[c + 1] += index.cell_start[c];
+    }
+
+    std::vector<Entry> sorted(index.entries.size());
+    std::vector<uint32_t> fill(index.cell_start.begin(), index.cell_start.end() - 1);
+    for (size_t i = 0; i < index.entries.size(); ++i) {
+        sorted[fill[cell_of[i]]++] = index.entries[i];
+    }
+    index.entries = std::move(sorted);
+
+    return index;
+}
+
+template <typename Visit>
+void SpatialIndex::search_rings(double lat, double lon, Visit&& visit) const {
+    if (entries.empty()) return;
+
+    // Partir du point de la grille le plus proche de la requête ; (dx0, dy0) est
+    // l'écart de la requête à la grille (nul si elle est dedans)
+    auto [x, y] = project(lat, lon);
+    const double px = std::clamp(x, min_x, min_x + cols * cell_size);
+    const double py = std::clamp(y, min_y, min_y + rows * cell_size);
+    const double dx0 = std::abs(x - px);
+    const double dy0 = std::abs(y - py);
+    const int cx = clamp_col(px);
+    const int cy = clamp_row(py);
+    const int max_ring = std::max({cx, cols - 1 - cx, cy, rows - 1 - cy});
+
+    // Minorant de la distance aux nodes hors des anneaux 0..r-1 : ils s'écartent
+    // d'au moins (r - 1) cellules du point de départ sur l'un des deux axes
+    auto ring_bound = [&](int r) {
+        const double d = (r - 1) * cell_size;
+        const double bx = (dx0 + d) * (dx0 + d) + dy0 * dy0;
+        const double by = dx0 * dx0 + (dy0 + d) * (dy0 + d);
+        return std::sqrt(std::min(bx, by)) * scale_floor;
+    };
+
+    double limit = std::numeric_limits<double>::infinity();
+
+    auto visit_cell = [&](int col, int row) {
+        const size_t cell = static_cast<size_t>(row) * cols + col;
+        for (uint32_t e = cell_start[cell]; e < cell_start[cell + 1]; ++e) {
+            const Entry& entry = entries[e];
+            limit = visit(entry.id, calculate_haversine_distance(lat, lon, entry.lat, entry.lon));
+        }
+    };
+
+    for (int r = 0; r <= max_ring; ++r) {
+        if (r > 0 && ring_bound(r) > limit) break;
+
+        const int row_begin = std::max(cy - r, 0);
+        const int row_end = std::min(cy + r, rows - 1);
+        const int col_begin = std::max(cx - r, 0);
+        const int col_end = std::min(cx + r, cols - 1);
+
+        for (int row = row_begin; row <= row_end; ++row) {
+            if (row == cy - r || row == cy + r) {
+                for (int col = col_begin; col <= col_end; ++col) visit_cell(col, row);
+            } else {
+                if (cx - r >= 0) visit_cell(cx - r, row);
+                if (r > 0 && cx + r < cols) visit_cell(cx + r, row);
+            }
+        }
+    }
+}
+
+osmium::object_id_type SpatialIndex::nearest(double lat, double lon, double* distance) const {
+    osmium::object_id_type best_id = 0;
+    double best = std::numeric_limits<double>::infinity();
+
+    search_rings(lat, lon, [&](osmium::object_id_type id, double d) {
+        if (d < best) {
+            best = d;
+            best_id = id;
+        }
+        return best;
+    });
+
+    if (distance) *distance = best;
+    return best_id;
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::k_nearest(double lat, double lon, size_t k) const {
+    std::vector<Neighbor> heap;
+    if (k == 0) return heap;
+    heap.reserve(k + 1);
+
+    auto farther = [](const Neighbor& a, const Neighbor& b) { return a.second < b.second; };
+
+    // Tas max des k meilleurs : la racine est le k-ième plus proche
+    search_rings(lat, lon, [&](osmium::object_id_type id, double d) {
+        if (heap.size() < k) {
+            heap.emplace_back(id, d);
+            std::push_heap(heap.begin(), heap.end(), farther);
+        } else if (d < heap.front().second) {
+            std::pop_heap(heap.begin(), heap.end(), farther);
+            heap.back() = {id, d};
+            std::push_heap(heap.begin(), heap.end(), farther);
+        }
+        return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.front().second;
+    });
+
+    std::sort_heap(heap.begin(), heap.end(), farther);
+    return heap;
+}
+
+std::vector<SpatialIndex::Neighbor> SpatialIndex::within_radius(double lat, double lon, double radius_meters) const {
+    std::vector<Neighbor> result;
+
+    search_rings(lat, lon, [&](osmium::object_id_type id, double d) {
+        if (d <= radius_meters) result.emplace_back(id, d);
+        return radius_meters;
+    });
+
+    std::sort(result.begin(), result.end(),
+        [](const Neighbor& a, const Neighbor& b) { return a.second < b.second; });
+    return result;
+}
@@ -0,0 +1,73 @@
+#ifndef SPATIAL_INDEX_HPP
+#define SPATIAL_INDEX_HPP
+
+#include "Box.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Grille uniforme sur les nodes de GeoBox::data pour les requêtes de proximité.
+// Les positions sont projetées en mètres (équirectangulaire autour de la latitude
+// moyenne) pour le découpage en cellules ; les distances renvoyées sont des
+// distances haversine, comme calculate_haversine_distance.
+// Les nodes sont rangés par cellule au format CSR : la cellule c occupe
+// [cell_start[c], cell_start[c + 1]) dans entries.
+class SpatialIndex {
+public:
+    // (id du node, distance en mètres)
+    using Neighbor = std::pair<osmium::object_id_type, double>;
+
+    SpatialIndex() = default;
+
+    // nodes_per_cell : occupation moyenne visée des cellules
+    static SpatialIndex build(const MyData& data, double nodes_per_cell = 4.0);
+
+    // Index restreint à un sous-ensemble de nodes (ids absents de data ignorés)
+    static SpatialIndex build(const MyData& data, const std::vector<osmium::object_id_type>& node_ids,
+                              double nodes_per_cell = 4.0);
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    // Node le plus proche (0 si l'index est vide) ; distance optionnelle en mètres
+    osmium::object_id_type nearest(double lat, double lon, double* distance = nullptr) const;
+
+    // Les k nodes les plus proches, par distance croissante
+    std::vector<Neighbor> k_nearest(double lat, double lon, size_t k) const;
+
+    // Nodes à moins de radius_meters, par distance croissante
+    std::vector<Neighbor> within_radius(double lat, double lon, double radius_meters) const;
+
+private:
+    struct Entry {
+        osmium::object_id_type id;
+        double lat;
+        double lon;
+    };
+
+    double cos_ref = 1.0;      // cos de la latitude de référence de la projection
+    double scale_floor = 1.0;  // Minorant du rapport distance vraie / distance projetée
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double cell_size = 1.0;  // Côté d'une cellule (mètres projetés)
+    int cols = 0;
+    int rows = 0;
+
+    std::vector<uint32_t> cell_start;
+    std::vector<Entry> entries;
+
+    static SpatialIndex from_entries(std::vector<Entry> entries, double nodes_per_cell);
+
+    std::pair<double, double> project(double lat, double lon) const;
+    int clamp_col(double x) const;
+    int clamp_row(double y) const;
+
+    // Parcours des cellules par anneaux (distance de Tchebychev) autour de la cellule
+    // de la requête ; visit(id, distance) renvoie la distance au-delà de laquelle
+    // les nodes ne sont plus utiles, ce qui arrête le parcours
+    template <typename Visit>
+    void search_rings(double lat, double lon, Visit&& visit) const;
+};
+
+#endif // SPATIAL_INDEX_HPP
@@ -2,16 +2,21 @@
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <limits>
+#include <memory>
 #include "Box.hpp"
 #include "MapRenderer.hpp"
 #include "GeoBoxManager.hpp"
+#include "GeoBoxCache.hpp"
 #include "Pathfinding.hpp"
 #include "utility.hpp"
+#include "PbfBlockIndex.hpp"
 #include <string>
 #include "MHProcs/ACO.hpp"
 #include "MHProcs/GRASP.hpp"
 #include "MHProcs/VNS.hpp"
 #include "MHProcs/PSO.hpp"
+#include "MHProcs/LK.hpp"
 #include "OverpassAPI/OverpassAPI.hpp"
 
 int main() {
@@ -69,11 +74,11 @@ int main() {
             break;
     }
     
-    const std::string cache_path = cache_dir + "\\" + location_name + ".json";
+    const std::string cache_path = cache_dir + "\\" + location_name + GeoBoxManager::CACHE_EXTENSION;
     std::cout << "=== Fin sélection localisation ===\n" << std::endl;
 
     std::string rep;
-    std::cout << "New Geobox and cache (G/g), Initialize POI (I/i), System Creation and Pathfinding (P/p), Mh procedure (A/a), Verify data (V/v), Verify Pf (F/f), Render only (R/r), Complete Graph (C/c): ";
+    std::cout << "New Geobox and cache (G/g), Initialize POI (I/i), System Creation and Pathfinding (P/p), Mh procedure (A/a), Verify data (V/v), Verify Pf (F/f), Render only (R/r), Complete Graph (C/c), Benchmark (B/b), Index PBF (X/x), All presets in one pass (M/m), Migrate caches (U/u), Export JSON (E/e), Archive compact cache (Z/z): ";
     std::cin >> rep;
 
     FlickrConfig config;
@@ -113,7 +118,7 @@ int main() {
 
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -135,7 +140,7 @@ int main() {
             
             std::cout << "Cache Name to save : ";
             std::cin >> cache_name;
-            cache_name = cache_dir + "//" + cache_name + ".json";
+            cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
             GeoBoxManager::save_geobox(geo_box, cache_name);
             std::cout << "GeoBox avec POI sauvegardée: " << cache_name << std::endl;
             
@@ -160,7 +165,7 @@ int main() {
         // Charger la GeoBox avec les objectifs déjà initialisés
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -173,6 +178,15 @@ int main() {
         }
 
         Pathfinder PfSystem(geo_box);
+        if (MappedGeoBox::is_binary_cache(cache_name)) {
+            // A* directement sur la projection du cache, sans construire de RoadGraph
+            PfSystem.use_mapped_graph(std::make_shared<const MappedGeoBox>(GeoBoxManager::map_geobox(cache_name)));
+        }
+
+        std::string contraction_input;
+        std::cout << "Contraction des chaînes de degré 2 (y/n) : ";
+        std::cin >> contraction_input;
+        PfSystem.set_chain_contraction(!contraction_input.empty() && (contraction_input[0] == 'y' || contraction_input[0] == 'Y'));
 
         auto debut = std::chrono::high_resolution_clock::now();
         
@@ -219,11 +233,12 @@ int main() {
         
         if (global_success) {
             std::cout << "Construction du sous-graphe réussie globalement!" << std::endl;
-            std::cout << "Cache Name to save : ";
+            const std::string base_cache = cache_name;
+            std::cout << "Overlay Name to save : ";
             std::cin >> cache_name;
-            cache_name = cache_dir + "//" + cache_name + ".json";
-            GeoBoxManager::save_geobox(geo_box, cache_name);
-            std::cout << "GeoBox avec pathfinding sauvegardée: " << cache_name << std::endl;
+            cache_name = cache_dir + "//" + cache_name + GeoBoxManager::OVERLAY_EXTENSION;
+            GeoBoxManager::save_overlay(geo_box, base_cache, cache_name);
+            std::cout << "Groupes de pathfinding sauvegardés: " << cache_name << std::endl;
         } else {
             std::cout << "Aucun pathfinding réussi" << std::endl;
         }
@@ -250,7 +265,7 @@ int main() {
         // Charger la GeoBox avec les objectifs déjà initialisés
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -263,6 +278,10 @@ int main() {
         }
         
         Pathfinder PfSystem(geo_box);
+        if (MappedGeoBox::is_binary_cache(cache_name)) {
+            // A* directement sur la projection du cache, sans construire de RoadGraph
+            PfSystem.use_mapped_graph(std::make_shared<const MappedGeoBox>(GeoBoxManager::map_geobox(cache_name)));
+        }
 
         int group_nb = 1;
         bool success = false;
@@ -288,11 +307,12 @@ int main() {
 
         if (success) {
             std::cout << "Construction du sous-graphe réussie!" << std::endl;
-            std::cout << "Cache Name to save : ";
+            const std::string base_cache = cache_name;
+            std::cout << "Overlay Name to save : ";
             std::cin >> cache_name;
-            cache_name = cache_dir + "//" + cache_name + ".json";
-            GeoBoxManager::save_geobox(geo_box, cache_name);
-            std::cout << "GeoBox avec pathfinding sauvegardée: " << cache_name << std::endl;
+            cache_name = cache_dir + "//" + cache_name + GeoBoxManager::OVERLAY_EXTENSION;
+            GeoBoxManager::save_overlay(geo_box, base_cache, cache_name);
+            std::cout << "Groupes de pathfinding sauvegardés: " << cache_name << std::endl;
         } else {
             std::cout << "Échec de la construction du sous-graphe" << std::endl;
         }
@@ -314,7 +334,7 @@ int main() {
         
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -324,6 +344,7 @@ int main() {
         
         // Appel de la fonction de validation depuis utility
         validate_data_integrity(geo_box);
+        verif_cache_roundtrip(geo_box, cache_dir);
         
     } else if (rep == "O" || rep == "o") {
     
@@ -371,7 +392,7 @@ int main() {
 
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
 
         if (!geo_box.is_valid) {
@@ -380,6 +401,10 @@ int main() {
         }
 
         Pathfinder PfSystem(geo_box);
+        if (MappedGeoBox::is_binary_cache(cache_name)) {
+            // A* directement sur la projection du cache, sans construire de RoadGraph
+            PfSystem.use_mapped_graph(std::make_shared<const MappedGeoBox>(GeoBoxManager::map_geobox(cache_name)));
+        }
 
         auto group_it = geo_box.data.objective_groups.find(group_nb);
         if (group_it == geo_box.data.objective_groups.end()) {
@@ -417,7 +442,7 @@ int main() {
         
         std::cout << "Cache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -441,6 +466,134 @@ int main() {
             std::cout << "Erreur lors du rendu de la carte" << std::endl;
         }
 
+    } else if (rep == "B" || rep == "b") {
+
+        // ========== BENCHMARKS ==========
+        std::cout << "\n=== Benchmarks ===" << std::endl;
+
+        std::cout << "Cache Name to load : ";
+        std::cin >> cache_name;
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
+        GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
+
+        if (!geo_box.is_valid) {
+            std::cout << "Erreur lors du chargement de la GeoBox" << std::endl;
+            return 0;
+        }
+
+        // Ligne entière : une entrée vide garde la valeur par défaut
+        std::string input;
+        std::cout << "Nombre de requêtes A* [50]: ";
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::getline(std::cin, input);
+        int nb_queries = 50;
+        try {
+            if (input.find_first_not_of(" \t\r") != std::string::npos) nb_queries = std::stoi(input);
+        } catch (const std::exception&) {
+            nb_queries = 0;
+        }
+        if (nb_queries < 1) {
+            std::cout << "Nombre de requêtes invalide (entier >= 1 attendu): " << input << std::endl;
+            return 0;
+        }
+
+        benchmark_pathfinding(geo_box, nb_queries);
+        benchmark_chain_contraction(geo_box, nb_queries);
+        benchmark_road_graph(geo_box);
+        benchmark_node_ordering(geo_box, nb_queries);
+        benchmark_cache_loading(geo_box, cache_dir, nb_queries);
+        benchmark_distance_matrix(geo_box);
+        benchmark_tour_distance(geo_box);
+        verif_move_evaluator(geo_box);
+        benchmark_ingest_memory(geo_box);
+
+    } else if (rep == "M" || rep == "m") {
+
+        // ========== TOUTES LES LOCALISATIONS EN UNE LECTURE ==========
+        std::cout << "\n=== GeoBox Asakusa, Shibuya et Shinjuku ===" << std::endl;
+
+        auto preset = [](double lon1, double lat1, double lon2, double lat2) {
+            osmium::Box box;
+            box.extend(osmium::Location(lon1, lat1));
+            box.extend(osmium::Location(lon2, lat2));
+            return box;
+        };
+
+        auto debut = std::chrono::high_resolution_clock::now();
+        create_save_batch(osm_file, {
+            {"asakusa", preset(139.785, 35.705, 139.800, 35.718)},
+            {"shibuya", preset(139.699, 35.658, 139.704, 35.661)},
+            {"shinjuku", preset(139.698, 35.689, 139.710, 35.702)}
+        }, cache_dir);
+        auto duree = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - debut);
+        std::cout << "Temps d'exécution: " << duree.count() << " ms" << std::endl;
+
+    } else if (rep == "U" || rep == "u") {
+
+        // ========== MIGRATION DES CACHES ==========
+        // Convertit chaque cache GeoBox JSON au format binaire (<nom>.gbx, JSON conservé)
+        std::cout << "\n=== Migration des caches de " << cache_dir << " ===" << std::endl;
+
+        int migrated = 0, failed = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+            const std::string filename = entry.path().filename().string();
+            if (entry.path().extension() != ".json" || filename.rfind("flickr_", 0) == 0
+                || filename == GeoBoxCache::INDEX_FILE) continue;
+
+            if (GeoBoxManager::migrate_cache(entry.path().string())) {
+                migrated++;
+            } else {
+                failed++;
+            }
+        }
+        std::cout << "Caches migrés: " << migrated << ", échecs: " << failed << std::endl;
+
+    } else if (rep == "E" || rep == "e") {
+
+        // ========== EXPORT JSON ==========
+        std::cout << "Cache Name to export : ";
+        std::cin >> cache_name;
+        GeoBox geo_box = GeoBoxManager::load_geobox(cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION);
+
+        if (!geo_box.is_valid) {
+            std::cout << "Erreur lors du chargement de la GeoBox" << std::endl;
+            return 0;
+        }
+        GeoBoxManager::export_geobox_json(geo_box, cache_dir + "//" + cache_name + ".json");
+
+    } else if (rep == "Z" || rep == "z") {
+
+        // ========== ARCHIVE COMPACTE ==========
+        // <nom>.gbz (LZ4) pour l'archivage ou le transfert ; relu par load_geobox si le .gbx est supprimé
+        std::cout << "Cache Name to archive : ";
+        std::cin >> cache_name;
+        GeoBox geo_box = GeoBoxManager::load_geobox(cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION);
+
+        if (!geo_box.is_valid) {
+            std::cout << "Erreur lors du chargement de la GeoBox" << std::endl;
+            return 0;
+        }
+        GeoBoxManager::save_geobox(geo_box, cache_dir + "//" + cache_name + GeoBoxManager::COMPACT_EXTENSION);
+
+    } else if (rep == "X" || rep == "x") {
+
+        // ========== INDEX SPATIAL DU PBF ==========
+        // Outil ponctuel : create_geo_box utilise ensuite l'index tant que le PBF n'a pas changé
+        std::cout << "\n=== Indexation des blocs de " << osm_file << " ===" << std::endl;
+
+        auto debut = std::chrono::high_resolution_clock::now();
+        auto index = PbfBlockIndex::build(osm_file);
+
+        if (index && index->save(PbfBlockIndex::index_path(osm_file))) {
+            auto duree = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - debut);
+            std::cout << "Index sauvegardé: " << PbfBlockIndex::index_path(osm_file)
+                      << " (" << duree.count() << " ms)" << std::endl;
+        } else {
+            std::cout << "Erreur lors de l'indexation du PBF" << std::endl;
+        }
+
     } else if (rep == "A" || rep == "a") {
         
         // ========== SELECTION DE LA METAHEURISTIQUE ==========
@@ -449,7 +602,8 @@ int main() {
         std::cout << "2. GRASP (Greedy Randomized Adaptive Search)" << std::endl;
         std::cout << "3. VNS (Variable Neighborhood Search)" << std::endl;
         std::cout << "4. PSO (Particle Swarm Optimization)" << std::endl;
-        std::cout << "Choisissez une méthode (1-4) : ";
+        std::cout << "5. LK (Or-opt + Lin-Kernighan itéré)" << std::endl;
+        std::cout << "Choisissez une méthode (1-5) : ";
         
         int metaheuristic_choice;
         std::cin >> metaheuristic_choice;
@@ -457,7 +611,7 @@ int main() {
         // Charger la GeoBox avec les objectifs déjà initialisés
         std::cout << "\nCache Name to load : ";
         std::cin >> cache_name;
-        cache_name = cache_dir + "//" + cache_name + ".json";
+        cache_name = cache_dir + "//" + cache_name + GeoBoxManager::CACHE_EXTENSION;
         GeoBox geo_box = GeoBoxManager::load_geobox(cache_name);
         
         if (!geo_box.is_valid) {
@@ -505,6 +659,10 @@ int main() {
                     std::cout << "Rho (évaporation) [" << aco_params.rho << "]: ";
                     std::cin >> input;
                     if (!input.empty()) aco_params.rho = std::stod(input);
+                    
+                    std::cout << "Graine (0 = aléatoire) [" << aco_params.seed << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) aco_params.seed = std::stoull(input);
                 }
 
                 std::cout << "\nParamètres ACO utilisés:" << std::endl;
@@ -571,6 +729,10 @@ int main() {
                     std::cout << "Utiliser 2-opt? (y/n) [" << (grasp_params.use_2opt ? "y" : "n") << "]: ";
                     std::cin >> input;
                     if (!input.empty()) grasp_params.use_2opt = (input[0] == 'y' || input[0] == 'Y');
+                    
+                    std::cout << "Voisins candidats par POI (0 = voisinages complets) [" << grasp_params.neighbor_list_size << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) grasp_params.neighbor_list_size = std::stoi(input);
                 }
 
                 std::cout << "\nParamètres GRASP utilisés:" << std::endl;
@@ -578,6 +740,7 @@ int main() {
                 std::cout << "  Alpha: " << grasp_params.alpha << std::endl;
                 std::cout << "  Recherche locale: " << grasp_params.local_search_iterations << std::endl;
                 std::cout << "  2-opt: " << (grasp_params.use_2opt ? "Oui" : "Non") << std::endl;
+                std::cout << "  Voisins candidats: " << grasp_params.neighbor_list_size << std::endl;
 
                 // Exécution GRASP
                 GRASPSolver grasp_solver(geo_box);
@@ -636,6 +799,10 @@ int main() {
                     std::cout << "First improvement? (y/n) [" << (vns_params.use_first_improvement ? "y" : "n") << "]: ";
                     std::cin >> input;
                     if (!input.empty()) vns_params.use_first_improvement = (input[0] == 'y' || input[0] == 'Y');
+                    
+                    std::cout << "Voisins candidats par POI (0 = voisinages complets) [" << vns_params.neighbor_list_size << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) vns_params.neighbor_list_size = std::stoi(input);
                 }
 
                 std::cout << "\nParamètres VNS utilisés:" << std::endl;
@@ -643,6 +810,7 @@ int main() {
                 std::cout << "  Voisinages: " << vns_params.max_neighborhoods << std::endl;
                 std::cout << "  Intensité: " << vns_params.shaking_intensity << std::endl;
                 std::cout << "  First improvement: " << (vns_params.use_first_improvement ? "Oui" : "Non") << std::endl;
+                std::cout << "  Voisins candidats: " << vns_params.neighbor_list_size << std::endl;
 
                 // Exécution VNS
                 VNSSolver vns_solver(geo_box);
@@ -705,6 +873,10 @@ int main() {
                     std::cout << "Coefficient social (c2) [" << pso_params.c2 << "]: ";
                     std::cin >> input;
                     if (!input.empty()) pso_params.c2 = std::stod(input);
+                    
+                    std::cout << "Voisins candidats par POI (0 = 2-opt complet) [" << pso_params.neighbor_list_size << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) pso_params.neighbor_list_size = std::stoi(input);
                 }
 
                 std::cout << "\nParamètres PSO utilisés:" << std::endl;
@@ -713,6 +885,7 @@ int main() {
                 std::cout << "  Inertie (w): " << pso_params.w << std::endl;
                 std::cout << "  Cognitif (c1): " << pso_params.c1 << std::endl;
                 std::cout << "  Social (c2): " << pso_params.c2 << std::endl;
+                std::cout << "  Voisins candidats: " << pso_params.neighbor_list_size << std::endl;
 
                 // Exécution PSO
                 PSOSolver pso_solver(geo_box);
@@ -743,6 +916,71 @@ int main() {
                 break;
             }
             
+            case 5: { // LK
+                std::cout << "\n=== PATHFINDING LK POUR TOUS LES GROUPES ===" << std::endl;
+                
+                // Configuration des paramètres LK
+                LKParams lk_params;
+                
+                std::cout << "\n=== Configuration LK ===" << std::endl;
+                std::cout << "Utiliser les paramètres par défaut? (y/n): ";
+                char use_default;
+                std::cin >> use_default;
+                
+                if (use_default != 'y' && use_default != 'Y') {
+                    std::cout << "Nombre de perturbations [" << lk_params.max_iterations << "]: ";
+                    std::string input;
+                    std::cin >> input;
+                    if (!input.empty()) lk_params.max_iterations = std::stoi(input);
+                    
+                    std::cout << "Profondeur max LK [" << lk_params.max_depth << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) lk_params.max_depth = std::stoi(input);
+                    
+                    std::cout << "Largeur premier niveau [" << lk_params.breadth << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) lk_params.breadth = std::stoi(input);
+                    
+                    std::cout << "Voisins candidats par POI (0 = tous) [" << lk_params.neighbor_list_size << "]: ";
+                    std::cin >> input;
+                    if (!input.empty()) lk_params.neighbor_list_size = std::stoi(input);
+                }
+
+                std::cout << "\nParamètres LK utilisés:" << std::endl;
+                std::cout << "  Perturbations: " << lk_params.max_iterations << std::endl;
+                std::cout << "  Profondeur: " << lk_params.max_depth << std::endl;
+                std::cout << "  Largeur: " << lk_params.breadth << std::endl;
+                std::cout << "  Voisins candidats: " << lk_params.neighbor_list_size << std::endl;
+
+                // Exécution LK
+                LKSolver lk_solver(geo_box);
+                for (auto& [group_id, group_info] : geo_box.data.objective_groups) {
+                    if (group_info.node_ids.size() < 2) {
+                        std::cout << "Groupe " << group_id << " ignoré (moins de 2 POI)" << std::endl;
+                        continue;
+                    }
+
+                    std::cout << "\n--- TRAITEMENT LK GROUPE " << group_id << " ---" << std::endl;
+                    std::cout << "Nom: " << group_info.name << std::endl;
+                    std::cout << "POI: " << group_info.node_ids.size() << std::endl;
+
+                    bool group_success = lk_solver.solve_single_group(
+                        group_info.node_ids, 
+                        group_id, 
+                        lk_params
+                    );
+
+                    if (group_success) {
+                        std::cout << "Groupe " << group_id << ": SUCCÈS" << std::endl;
+                        processed_groups++;
+                    } else {
+                        std::cout << "Groupe " << group_id << ": ÉCHEC" << std::endl;
+                        overall_success = false;
+                    }
+                }
+                break;
+            }
+            
             default:
                 std::cout << "Choix invalide, utilisation d'ACO par défaut" << std::endl;
                 ACOSolver default_aco_solver(geo_box);
@@ -768,11 +1006,12 @@ int main() {
         std::cout << "Statut global: " << (overall_success ? "SUCCÈS" : "PARTIEL") << std::endl;
 
         if (processed_groups > 0) {
-            std::cout << "\nCache Name to save : ";
+            const std::string base_cache = cache_name;
+            std::cout << "\nOverlay Name to save : ";
             std::cin >> cache_name;
-            cache_name = cache_dir + "//" + cache_name + ".json";
-            GeoBoxManager::save_geobox(geo_box, cache_name);
-            std::cout << "GeoBox avec pathfinding métaheuristique sauvegardée: " << cache_name << std::endl;
+            cache_name = cache_dir + "//" + cache_name + GeoBoxManager::OVERLAY_EXTENSION;
+            GeoBoxManager::save_overlay(geo_box, base_cache, cache_name);
+            std::cout << "Groupes de pathfinding métaheuristique sauvegardés: " << cache_name << std::endl;
         }
 
         std::string output_name;
@@ -1,9 +1,39 @@
 #include <iostream>
 #include <iomanip>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <cmath>
+#include <bit>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <unordered_map>
+#include <osmium/visitor.hpp>
+#include <osmium/io/any_input.hpp>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#endif
 #include "Box.hpp"
 #include "MapRenderer.hpp"
 #include "GeoBoxManager.hpp"
+#include "GeoBoxCache.hpp"
 #include "Pathfinding.hpp"
+#include "RoadGraph.hpp"
+#include "AStar.hpp"
+#include "MappedGeoBox.hpp"
+#include "MHProcs/DistanceMatrix.hpp"
+#include "MHProcs/MoveEvaluator.hpp"
+#include "Common/ThreadPool.hpp"
 #include "utility.hpp"
 
 int test() {
@@ -172,39 +202,61 @@ void complete_workflow(const std::string& osm_file,
                       const FlickrConfig& flickr_config,
                       bool use_flickr_objectives) {
     
-    // Générer le nom complet du cache
-    std::string cache_name = GeoBoxManager::generate_cache_name(cache_prefix);
-    std::string cache_path = cache_dir + "\\" + cache_name;
+    // Clé des entrées : fichier OSM, bbox et options qui changent le contenu de la GeoBox
+    osmium::Box bbox;
+    bbox.extend(osmium::Location(min_lon, min_lat));
+    bbox.extend(osmium::Location(max_lon, max_lat));
+    const std::string options = GeoBoxCache::workflow_options(use_flickr_objectives, flickr_config);
+    const std::string key = GeoBoxCache::make_key(osm_file, bbox, options);
     
-    std::cout << "Étape 1: Création de la GeoBox..." << std::endl;
-    GeoBox original_geo_box = create_geo_box(osm_file, min_lon, min_lat, max_lon, max_lat);
+    // Nom lisible (invites "Cache Name to load") et fichier adressé par la clé
+    const std::string alias_path = cache_dir + "\\" + GeoBoxManager::generate_cache_name(cache_prefix);
+    std::string cache_path = GeoBoxCache::find(cache_dir, key);
+    GeoBox loaded_geo_box;
     
-    if (!original_geo_box.is_valid) {
-        std::cout << "Erreur lors de la création de la GeoBox" << std::endl;
-        return;
+    if (!cache_path.empty()) {
+        std::cout << "Étape 1: GeoBox identique en cache (clé " << key << "), pas de reconstruction" << std::endl;
+        loaded_geo_box = GeoBoxManager::load_geobox(cache_path);
     }
     
-    if (use_flickr_objectives) {
-        std::cout << "Application des objectifs Flickr..." << std::endl;
-        FlickrConfig adapted_config = flickr_config;
-        adapted_config.bbox = std::to_string(min_lon) + "," + std::to_string(min_lat) + "," + 
-                             std::to_string(max_lon) + "," + std::to_string(max_lat);
+    if (!loaded_geo_box.is_valid) {
+        cache_path = key.empty() ? alias_path : GeoBoxCache::entry_path(cache_dir, cache_prefix, key);
         
-        original_geo_box = apply_objectives(original_geo_box, adapted_config, "flickr_cache.json", true, 1);
-    }
-    
-    std::cout << "Étape 2: Sauvegarde..." << std::endl;
-    if (!GeoBoxManager::save_geobox(original_geo_box, cache_path)) {
-        std::cout << "Erreur lors de la sauvegarde" << std::endl;
-        return;
-    }
+        std::cout << "Étape 1: Création de la GeoBox..." << std::endl;
+        GeoBox original_geo_box = create_geo_box(osm_file, min_lon, min_lat, max_lon, max_lat);
+        
+        if (!original_geo_box.is_valid) {
+            std::cout << "Erreur lors de la création de la GeoBox" << std::endl;
+            return;
+        }
+        
+        if (use_flickr_objectives) {
+            std::cout << "Application des objectifs Flickr..." << std::endl;
+            FlickrConfig adapted_config = flickr_config;
+            adapted_config.bbox = std::to_string(min_lon) + "," + std::to_string(min_lat) + "," + 
+                                 std::to_string(max_lon) + "," + std::to_string(max_lat);
+            
+            original_geo_box = apply_objectives(original_geo_box, adapted_config, "flickr_cache.json", true, 1);
+        }
+        
+        std::cout << "Étape 2: Sauvegarde..." << std::endl;
+        if (!GeoBoxManager::save_geobox(original_geo_box, cache_path)) {
+            std::cout << "Erreur lors de la sauvegarde" << std::endl;
+            return;
+        }
+        GeoBoxCache::record(cache_dir, key, cache_path, original_geo_box, options);
 
-    std::cout << "Étape 3: Rechargement depuis le cache..." << std::endl;
-    GeoBox loaded_geo_box = GeoBoxManager::load_geobox(cache_path);
+        std::cout << "Étape 3: Rechargement depuis le cache..." << std::endl;
+        loaded_geo_box = GeoBoxManager::load_geobox(cache_path);
+        
+        if (!loaded_geo_box.is_valid) {
+            std::cout << "Erreur lors du rechargement" << std::endl;
+            return;
+        }
+    }
     
-    if (!loaded_geo_box.is_valid) {
-        std::cout << "Erreur lors du rechargement" << std::endl;
-        return;
+    if (cache_path != alias_path) {
+        GeoBoxCache::publish(cache_path, alias_path);
     }
 
     std::cout << "Étape 4: Rendu de la carte..." << std::endl;
@@ -214,6 +266,60 @@ void complete_workflow(const std::string& osm_file,
     }
 }
 
+void create_save_batch(const std::string& osm_file,
+                       const std::vector<std::pair<std::string, osmium::Box>>& regions,
+                       const std::string& cache_dir) {
+    
+    // Régions déjà en cache avec les mêmes entrées : seulement republiées sous leur nom.
+    // Sans objectifs : mêmes clés que complete_workflow sans Flickr sur la même bbox
+    const std::string options = GeoBoxCache::workflow_options(false);
+    std::vector<std::string> keys;
+    std::vector<size_t> to_build;
+    std::vector<osmium::Box> bboxes;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& [name, bbox] = regions[i];
+        keys.push_back(GeoBoxCache::make_key(osm_file, bbox, options));
+        const std::string alias_path = cache_dir + "\\" + GeoBoxManager::generate_cache_name(name + "_raw");
+        const std::string cached = GeoBoxCache::find(cache_dir, keys.back());
+        if (!cached.empty()) {
+            std::cout << name << " : GeoBox identique en cache (clé " << keys.back() << ")" << std::endl;
+            GeoBoxCache::publish(cached, alias_path);
+            continue;
+        }
+        to_build.push_back(i);
+        bboxes.push_back(bbox);
+    }
+    if (to_build.empty()) {
+        return;
+    }
+    
+    std::cout << "Création de " << bboxes.size() << " GeoBox en une lecture..." << std::endl;
+    std::vector<GeoBox> geo_boxes = create_geo_boxes(osm_file, bboxes);
+    
+    for (size_t b = 0; b < to_build.size(); ++b) {
+        const size_t i = to_build[b];
+        const std::string& name = regions[i].first;
+        
+        if (!geo_boxes[b].is_valid) {
+            std::cout << "Erreur lors de la création de la GeoBox " << name << std::endl;
+            continue;
+        }
+        
+        std::string cache_path = cache_dir + "\\" + GeoBoxManager::generate_cache_name(name + "_raw");
+        if (!keys[i].empty()) {
+            const std::string entry = GeoBoxCache::entry_path(cache_dir, name + "_raw", keys[i]);
+            if (GeoBoxManager::save_geobox(geo_boxes[b], entry)) {
+                GeoBoxCache::record(cache_dir, keys[i], entry, geo_boxes[b], options);
+                GeoBoxCache::publish(entry, cache_path);
+                continue;
+            }
+        }
+        if (!GeoBoxManager::save_geobox(geo_boxes[b], cache_path)) {
+            std::cout << "Erreur lors de la sauvegarde de " << name << std::endl;
+        }
+    }
+}
+
 void validate_data_integrity(const GeoBox& geo_box) {
     std::cout << "\n=== VALIDATION DE L'INTÉGRITÉ DES DONNÉES ===" << std::endl;
     
@@ -330,51 +436,54 @@ void validate_data_integrity(const GeoBox& geo_box) {
     }
 }
 
-bool verif_pathfinding(Pathfinder& PfSystem,
-    const std::vector<osmium::object_id_type>& objective_nodes,
-    int path_group){
+// Parcours d'une composante du sous-graphe (arêtes du groupe uniquement) sur l'instantané CSR
+static bool verif_component(const RoadGraph& rg,
+    const std::vector<char>& edge_in_group,
+    const std::vector<osmium::object_id_type>& objective_nodes){
 
         if(objective_nodes.empty()){
             return false;
         }
 
-        std::vector<osmium::object_id_type> file = {objective_nodes[0]};
-        std::unordered_set<osmium::object_id_type> visited;
-        std::unordered_set<osmium::object_id_type> objective_set(objective_nodes.begin(), objective_nodes.end());
-
-        int counter = 0;
+        std::vector<char> visited(rg.num_nodes(), 0);
+        std::vector<char> is_objective(rg.num_nodes(), 0);
+        for(const auto& node_id : objective_nodes){
+            uint32_t u = rg.index_of(node_id);
+            if(u != RoadGraph::INVALID_INDEX) is_objective[u] = 1;
+        }
 
-        while (!file.empty()){
+        size_t counter = 0;
+        std::vector<uint32_t> file;
+        uint32_t start = rg.index_of(objective_nodes[0]);
+        if(start != RoadGraph::INVALID_INDEX){
+            file.push_back(start);
+            visited[start] = 1;
+        }
 
-            osmium::object_id_type act_node = file[0];
-            file.erase(file.begin());
+        for(size_t head = 0; head < file.size(); ++head){
+            uint32_t act_node = file[head];
 
-            if(visited.count(act_node)) continue;
-            visited.insert(act_node);
-            
-            if(objective_set.count(act_node)){
+            if(is_objective[act_node]){
                 counter++;
-                if(counter==objective_nodes.size()){
+                if(counter == objective_nodes.size()){
                     return true;
-                }  
+                }
             }
 
-            for(const auto& in_way : PfSystem.geo_box.data.nodes[act_node].incident_ways){
-                auto& act_way = PfSystem.geo_box.data.ways[in_way];
-                if(act_way.has_group(path_group)){
-                    if(act_node == act_way.node1_id){
-                        file.push_back(act_way.node2_id);
-                    } else {
-                        file.push_back(act_way.node1_id);
-                    }
+            for(uint32_t e = rg.edge_begin(act_node); e < rg.edge_end(act_node); ++e){
+                uint32_t neighbor = rg.edge_target(e);
+                if(edge_in_group[e] && !visited[neighbor]){
+                    visited[neighbor] = 1;
+                    file.push_back(neighbor);
                 }
             }
         }
 
         std::vector<osmium::object_id_type> next_check = {};
-        
+
         for(const auto& visited_node : objective_nodes){
-            if(!visited.count(visited_node)){
+            uint32_t u = rg.index_of(visited_node);
+            if(u == RoadGraph::INVALID_INDEX || !visited[u]){
                 next_check.push_back(visited_node);
             }
         }
@@ -384,14 +493,1151 @@ bool verif_pathfinding(Pathfinder& PfSystem,
         std::cout << "----------------------" << std::endl;
 
         for(const auto& visited_node : objective_nodes){
-            if(visited.count(visited_node)){
+            uint32_t u = rg.index_of(visited_node);
+            if(u != RoadGraph::INVALID_INDEX && visited[u]){
                 std::cout << "Deja visite : " << visited_node << std::endl;
             }
         }
 
-        if(!next_check.empty()){
-            verif_pathfinding(PfSystem, next_check, path_group);
+        // Un node objectif absent du graphe ne peut jamais être atteint
+        if(!next_check.empty() && next_check.size() < objective_nodes.size()){
+            verif_component(rg, edge_in_group, next_check);
         }
 
         return false;
-    }
\ No newline at end of file
+    }
+
+bool verif_pathfinding(Pathfinder& PfSystem,
+    const std::vector<osmium::object_id_type>& objective_nodes,
+    int path_group){
+
+        if(objective_nodes.empty()){
+            return false;
+        }
+
+        std::shared_ptr<const RoadGraph> snapshot = PfSystem.road_graph();
+        const RoadGraph& rg = *snapshot;
+
+        // Appartenance au groupe évaluée une seule fois par arête
+        std::vector<char> edge_in_group(rg.num_edges(), 0);
+        for(uint32_t e = 0; e < rg.num_edges(); ++e){
+            auto way_it = PfSystem.geo_box.data.ways.find(rg.edge_way_id(e));
+            edge_in_group[e] = (way_it != PfSystem.geo_box.data.ways.end() && way_it->second.has_group(path_group));
+        }
+
+        return verif_component(rg, edge_in_group, objective_nodes);
+    }
+
+// ====================================================================
+// BENCHMARKS
+// ====================================================================
+
+// Ancienne version de A_Star_Search (open set en vecteur + scan linéaire, h = 0),
+// conservée uniquement comme référence pour les benchmarks
+static std::vector<osmium::object_id_type> legacy_a_star_search(
+    MyData& data,
+    osmium::object_id_type start_point,
+    osmium::object_id_type end_point,
+    size_t& expanded_nodes) {
+
+    expanded_nodes = 0;
+    std::vector<osmium::object_id_type> open = {start_point};
+    std::unordered_map<osmium::object_id_type, std::pair<osmium::object_id_type, osmium::object_id_type>> cameFrom;
+    std::unordered_map<osmium::object_id_type, float> GScore;
+    GScore[start_point] = 0.0f;
+
+    while (!open.empty()) {
+        size_t best_index = 0;
+        for (size_t i = 1; i < open.size(); ++i) {
+            if (GScore[open[i]] < GScore[open[best_index]]) {
+                best_index = i;
+            }
+        }
+
+        osmium::object_id_type actual_node = open[best_index];
+        expanded_nodes++;
+
+        if (actual_node == end_point) {
+            std::vector<osmium::object_id_type> way_path;
+            while (cameFrom.count(actual_node)) {
+                way_path.push_back(cameFrom[actual_node].second);
+                actual_node = cameFrom[actual_node].first;
+            }
+            std::reverse(way_path.begin(), way_path.end());
+            return way_path;
+        }
+
+        open.erase(open.begin() + best_index);
+
+        for (const auto& way_id : data.nodes[actual_node].incident_ways) {
+            auto& way = data.ways[way_id];
+            osmium::object_id_type neighbor = (way.node1_id == actual_node) ? way.node2_id : way.node1_id;
+
+            float tentative_gScore = GScore[actual_node] + way.distance_meters;
+            if (!GScore.count(neighbor) || tentative_gScore < GScore[neighbor]) {
+                cameFrom[neighbor] = std::make_pair(actual_node, way_id);
+                GScore[neighbor] = tentative_gScore;
+                open.push_back(neighbor);
+            }
+        }
+    }
+
+    return {};
+}
+
+static double path_length(const MyData& data, const std::vector<osmium::object_id_type>& path) {
+    double length = 0.0;
+    for (const auto& way_id : path) {
+        auto way_it = data.ways.find(way_id);
+        if (way_it != data.ways.end()) {
+            length += way_it->second.distance_meters;
+        }
+    }
+    return length;
+}
+
+// Ids des nodes triés : base reproductible des tirages (l'ordre de parcours de la map ne l'est pas)
+static std::vector<osmium::object_id_type> sorted_node_ids(const MyData& data) {
+    std::vector<osmium::object_id_type> node_ids;
+    node_ids.reserve(data.nodes.size());
+    for (const auto& [node_id, point] : data.nodes) {
+        node_ids.push_back(node_id);
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+    return node_ids;
+}
+
+// nb_queries paires (départ, arrivée) tirées uniformément parmi node_ids
+static std::vector<std::pair<osmium::object_id_type, osmium::object_id_type>> random_queries(
+    const std::vector<osmium::object_id_type>& node_ids, int nb_queries, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> pick(0, node_ids.size() - 1);
+    std::vector<std::pair<osmium::object_id_type, osmium::object_id_type>> queries;
+    queries.reserve(nb_queries);
+    for (int i = 0; i < nb_queries; ++i) {
+        const osmium::object_id_type start = node_ids[pick(rng)];  // Tirages séquencés : même ordre sur tous les compilateurs
+        queries.emplace_back(start, node_ids[pick(rng)]);
+    }
+    return queries;
+}
+
+// Au plus nb_poi nodes distincts tirés au hasard
+static std::vector<osmium::object_id_type> random_pois(const MyData& data, int nb_poi, std::mt19937& rng) {
+    std::vector<osmium::object_id_type> node_ids = sorted_node_ids(data);
+    std::shuffle(node_ids.begin(), node_ids.end(), rng);
+    node_ids.resize(std::min<size_t>(node_ids.size(), nb_poi));
+    return node_ids;
+}
+
+void benchmark_pathfinding(GeoBox& geo_box, int nb_queries, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK PATHFINDING ===" << std::endl;
+
+    if (geo_box.data.nodes.size() < 2 || nb_queries < 1) {
+        std::cout << "GeoBox trop petite pour le benchmark" << std::endl;
+        return;
+    }
+
+    // Paires de requêtes reproductibles (seed fixe)
+    const std::vector<osmium::object_id_type> node_ids = sorted_node_ids(geo_box.data);
+    std::mt19937 rng(seed);
+    const auto queries = random_queries(node_ids, nb_queries, rng);
+
+    Pathfinder PfSystem(geo_box);
+    PfSystem.A_Star_Search(queries[0].first, queries[0].second); // Précalcul de l'heuristique
+
+    size_t legacy_expanded = 0, new_expanded = 0;
+    double legacy_ms = 0.0, new_ms = 0.0;
+    int mismatches = 0;
+
+    for (const auto& [start, end] : queries) {
+        size_t expanded = 0;
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        auto legacy_path = legacy_a_star_search(geo_box.data, start, end, expanded);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        legacy_expanded += expanded;
+        legacy_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        t0 = std::chrono::high_resolution_clock::now();
+        auto new_path = PfSystem.A_Star_Search(start, end, &expanded);
+        t1 = std::chrono::high_resolution_clock::now();
+        new_expanded += expanded;
+        new_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        // Les deux recherches doivent trouver des chemins de même longueur (à l'arrondi près)
+        if (std::abs(path_length(geo_box.data, legacy_path) - path_length(geo_box.data, new_path)) > 0.5) {
+            mismatches++;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Requêtes: " << nb_queries << " (nodes: " << node_ids.size() << ")" << std::endl;
+    std::cout << "Ancienne version : " << legacy_expanded << " nodes développés, " 
+              << legacy_ms << " ms (" << legacy_ms / nb_queries << " ms/requête)" << std::endl;
+    std::cout << "Nouvelle version : " << new_expanded << " nodes développés, " 
+              << new_ms << " ms (" << new_ms / nb_queries << " ms/requête)" << std::endl;
+    if (new_ms > 0.0) {
+        std::cout << "Accélération: x" << legacy_ms / new_ms << std::endl;
+    }
+    std::cout << "Chemins de longueur différente: " << mismatches << std::endl;
+}
+
+void benchmark_chain_contraction(GeoBox& geo_box, int nb_queries, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK CONTRACTION DES CHAÎNES DE DEGRÉ 2 ===" << std::endl;
+
+    Pathfinder full(geo_box);
+    Pathfinder contracted(geo_box);
+    contracted.set_chain_contraction(true);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::shared_ptr<const RoadGraph> rg = contracted.road_graph();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::shared_ptr<const RoadGraph> full_rg = full.road_graph();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Complet  : " << full_rg->num_nodes() << " nodes, " << full_rg->num_edges() << " arêtes orientées" << std::endl;
+    std::cout << "Contracté: " << rg->num_nodes() << " nodes, " << rg->num_edges() << " arêtes orientées ("
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms)" << std::endl;
+
+    if (rg->num_nodes() < 2) {
+        std::cout << "Graphe contracté trop petit pour le benchmark" << std::endl;
+        return;
+    }
+
+    // Requêtes entre nodes conservés par la contraction (intersections, POI)
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> dist(0, rg->num_nodes() - 1);
+
+    size_t full_expanded = 0, contracted_expanded = 0;
+    double full_ms = 0.0, contracted_ms = 0.0;
+    int mismatches = 0;
+
+    for (int i = 0; i < nb_queries; ++i) {
+        const osmium::object_id_type start = rg->node_id(dist(rng));
+        const osmium::object_id_type end = rg->node_id(dist(rng));
+        size_t expanded = 0;
+
+        t0 = std::chrono::high_resolution_clock::now();
+        auto full_path = full.A_Star_Search(start, end, &expanded);
+        t1 = std::chrono::high_resolution_clock::now();
+        full_expanded += expanded;
+        full_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        t0 = std::chrono::high_resolution_clock::now();
+        auto contracted_path = contracted.A_Star_Search(start, end, &expanded);
+        t1 = std::chrono::high_resolution_clock::now();
+        contracted_expanded += expanded;
+        contracted_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        // Les chemins dépliés doivent avoir la même longueur (à l'arrondi près)
+        if (std::abs(path_length(geo_box.data, full_path) - path_length(geo_box.data, contracted_path)) > 0.5) {
+            mismatches++;
+        }
+    }
+
+    std::cout << "Requêtes: " << nb_queries << std::endl;
+    std::cout << "Complet  : " << full_expanded << " nodes développés, " << full_ms << " ms" << std::endl;
+    std::cout << "Contracté: " << contracted_expanded << " nodes développés, " << contracted_ms << " ms" << std::endl;
+    if (contracted_expanded > 0) {
+        std::cout << "Nodes développés: x" << static_cast<double>(full_expanded) / contracted_expanded << " de moins" << std::endl;
+    }
+    std::cout << "Chemins de longueur différente: " << mismatches << std::endl;
+}
+
+void benchmark_road_graph(const GeoBox& geo_box, int repetitions) {
+    std::cout << "\n=== BENCHMARK ROADGRAPH (CSR) ===" << std::endl;
+
+    const MyData& data = geo_box.data;
+    if (data.nodes.empty()) {
+        std::cout << "GeoBox vide" << std::endl;
+        return;
+    }
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    RoadGraph rg = RoadGraph::build(data);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double build_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    // Parcours complet (toutes composantes) via les unordered_map de MyData
+    double map_ms = 0.0;
+    size_t map_visited = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        t0 = std::chrono::high_resolution_clock::now();
+        std::unordered_set<osmium::object_id_type> visited;
+        map_visited = 0;
+        for (const auto& [node_id, node] : data.nodes) {
+            if (!visited.count(node_id)) {
+                std::vector<osmium::object_id_type> component;
+                bfs_explore(data, node_id, visited, component);
+                map_visited += component.size();
+            }
+        }
+        t1 = std::chrono::high_resolution_clock::now();
+        map_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+
+    // Même parcours sur les tableaux CSR
+    double csr_ms = 0.0;
+    size_t csr_visited = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        t0 = std::chrono::high_resolution_clock::now();
+        std::vector<char> visited(rg.num_nodes(), 0);
+        std::vector<uint32_t> queue;
+        queue.reserve(rg.num_nodes());
+        for (uint32_t start = 0; start < rg.num_nodes(); ++start) {
+            if (visited[start]) continue;
+            queue.clear();
+            queue.push_back(start);
+            visited[start] = 1;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                uint32_t u = queue[head];
+                for (uint32_t e = rg.edge_begin(u); e < rg.edge_end(u); ++e) {
+                    uint32_t v = rg.edge_target(e);
+                    if (!visited[v]) {
+                        visited[v] = 1;
+                        queue.push_back(v);
+                    }
+                }
+            }
+        }
+        csr_visited = rg.num_nodes();
+        t1 = std::chrono::high_resolution_clock::now();
+        csr_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    }
+
+    // Estimation de la mémoire parcourue : nodes + ways + vecteurs incident_ways
+    size_t map_bytes = data.nodes.size() * (sizeof(std::pair<const osmium::object_id_type, MyData::Point>) + 2 * sizeof(void*))
+                     + data.ways.size() * (sizeof(std::pair<const osmium::object_id_type, MyData::Way>) + 2 * sizeof(void*));
+    for (const auto& [node_id, node] : data.nodes) {
+        map_bytes += node.incident_ways.capacity() * sizeof(osmium::object_id_type);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Nodes: " << rg.num_nodes() << ", arêtes orientées: " << rg.num_edges() << std::endl;
+    std::cout << "Construction CSR: " << build_ms << " ms" << std::endl;
+    std::cout << "Mémoire approx. MyData (maps): " << map_bytes / 1024 << " Ko" << std::endl;
+    std::cout << "Mémoire approx. RoadGraph (CSR): " << rg.memory_bytes() / 1024 << " Ko" << std::endl;
+    std::cout << "Parcours complet maps : " << map_ms / repetitions << " ms (" << map_visited << " nodes)" << std::endl;
+    std::cout << "Parcours complet CSR  : " << csr_ms / repetitions << " ms (" << csr_visited << " nodes)" << std::endl;
+    if (csr_ms > 0.0) {
+        std::cout << "Accélération: x" << map_ms / csr_ms << std::endl;
+    }
+    std::cout << "(Les défauts de cache se mesurent avec un profileur matériel, ex. perf stat -e cache-misses)" << std::endl;
+}
+
+// Distance A* (a_star_search) entre deux nodes d'un graphe CSR (RoadGraph ou MappedGeoBox),
+// -1 si l'un est absent ou inaccessible
+template <typename Graph>
+static double a_star_distance(const Graph& graph, SearchWorkspace& workspace, osmium::object_id_type start,
+                              osmium::object_id_type target, size_t& expanded_nodes) {
+    const uint32_t u = graph.index_of(start);
+    const uint32_t v = graph.index_of(target);
+    if (u == RoadGraph::INVALID_INDEX || v == RoadGraph::INVALID_INDEX ||
+        !a_star_search(graph, workspace, u, v, &expanded_nodes)) {
+        return -1.0;
+    }
+    return workspace.g_score[v];
+}
+
+void benchmark_node_ordering(const GeoBox& geo_box, int nb_queries, int repetitions, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK ORDRE DES NODES (IDS OSM vs COURBE DE HILBERT) ===" << std::endl;
+
+    const MyData& data = geo_box.data;
+    if (data.nodes.size() < 2) {
+        std::cout << "GeoBox trop petite pour le benchmark" << std::endl;
+        return;
+    }
+
+    const RoadGraph by_id = RoadGraph::build(data, false, RoadGraph::NodeOrder::ById);
+    auto t0 = std::chrono::high_resolution_clock::now();
+    const RoadGraph hilbert = RoadGraph::build(data, false, RoadGraph::NodeOrder::Hilbert);
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    // Localité : écart moyen d'indice entre les deux extrémités d'une arête
+    auto mean_gap = [](const RoadGraph& rg) {
+        double total = 0.0;
+        for (uint32_t u = 0; u < rg.num_nodes(); ++u) {
+            for (uint32_t e = rg.edge_begin(u); e < rg.edge_end(u); ++e) {
+                total += std::abs(static_cast<double>(rg.edge_target(e)) - u);
+            }
+        }
+        return rg.num_edges() > 0 ? total / rg.num_edges() : 0.0;
+    };
+
+    // Parcours en largeur complet (toutes composantes)
+    auto bfs_ms = [&](const RoadGraph& rg) {
+        double ms = 0.0;
+        std::vector<char> visited;
+        std::vector<uint32_t> queue;
+        queue.reserve(rg.num_nodes());
+        for (int r = 0; r < repetitions; ++r) {
+            auto b0 = std::chrono::high_resolution_clock::now();
+            visited.assign(rg.num_nodes(), 0);
+            for (uint32_t start = 0; start < rg.num_nodes(); ++start) {
+                if (visited[start]) continue;
+                queue.clear();
+                queue.push_back(start);
+                visited[start] = 1;
+                for (size_t head = 0; head < queue.size(); ++head) {
+                    const uint32_t u = queue[head];
+                    for (uint32_t e = rg.edge_begin(u); e < rg.edge_end(u); ++e) {
+                        const uint32_t v = rg.edge_target(e);
+                        if (!visited[v]) {
+                            visited[v] = 1;
+                            queue.push_back(v);
+                        }
+                    }
+                }
+            }
+            auto b1 = std::chrono::high_resolution_clock::now();
+            ms += std::chrono::duration<double, std::milli>(b1 - b0).count();
+        }
+        return ms / repetitions;
+    };
+
+    // Requêtes A* identiques (mêmes ids OSM) sur les deux numérotations
+    std::mt19937 rng(seed);
+    const auto queries = random_queries(sorted_node_ids(data), nb_queries, rng);
+
+    auto a_star_ms = [&](const RoadGraph& rg, double& total_distance, size_t& expanded) {
+        SearchWorkspace workspace;
+        total_distance = 0.0;
+        expanded = 0;
+        auto a0 = std::chrono::high_resolution_clock::now();
+        for (const auto& [start, end] : queries) {
+            const double d = a_star_distance(rg, workspace, start, end, expanded);
+            if (d > 0.0) total_distance += d;
+        }
+        auto a1 = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(a1 - a0).count();
+    };
+
+    // Préparation du rendu : segments (lon, lat) et groupe principal de chaque way
+    struct Segment {
+        double lon1, lat1, lon2, lat2;
+        int groupe;
+    };
+    std::vector<Segment> segments;
+    segments.reserve(data.ways.size());
+
+    auto render_prep_ms = [&](const RoadGraph& rg) {
+        double ms = 0.0;
+        for (int r = 0; r < repetitions; ++r) {
+            auto p0 = std::chrono::high_resolution_clock::now();
+            segments.clear();
+            for (uint32_t u = 0; u < rg.num_nodes(); ++u) {
+                for (uint32_t e = rg.edge_begin(u); e < rg.edge_end(u); ++e) {
+                    const uint32_t v = rg.edge_target(e);
+                    if (v < u) continue;  // Une seule des deux arêtes orientées
+                    const uint64_t mask = rg.group_mask(u) & rg.group_mask(v);
+                    segments.push_back({rg.lon(u), rg.lat(u), rg.lon(v), rg.lat(v),
+                                        mask ? std::countr_zero(mask) : 0});
+                }
+            }
+            auto p1 = std::chrono::high_resolution_clock::now();
+            ms += std::chrono::duration<double, std::milli>(p1 - p0).count();
+        }
+        return ms / repetitions;
+    };
+
+    // Référence : même préparation via les unordered_map de MyData (comme MapRenderer)
+    double map_prep_ms = 0.0;
+    for (int r = 0; r < repetitions; ++r) {
+        auto p0 = std::chrono::high_resolution_clock::now();
+        segments.clear();
+        for (const auto& [way_id, way] : data.ways) {
+            auto it1 = data.nodes.find(way.node1_id);
+            auto it2 = data.nodes.find(way.node2_id);
+            if (it1 == data.nodes.end() || it2 == data.nodes.end() || way.node1_id == way.node2_id) continue;
+            segments.push_back({it1->second.lon, it1->second.lat, it2->second.lon, it2->second.lat,
+                                way.groupes.empty() ? 0 : *way.groupes.begin()});
+        }
+        auto p1 = std::chrono::high_resolution_clock::now();
+        map_prep_ms += std::chrono::duration<double, std::milli>(p1 - p0).count();
+    }
+    map_prep_ms /= repetitions;
+
+    double id_distance = 0.0, hilbert_distance = 0.0;
+    size_t id_expanded = 0, hilbert_expanded = 0;
+    const double id_bfs = bfs_ms(by_id);
+    const double hilbert_bfs = bfs_ms(hilbert);
+    const double id_a_star = a_star_ms(by_id, id_distance, id_expanded);
+    const double hilbert_a_star = a_star_ms(hilbert, hilbert_distance, hilbert_expanded);
+    const double id_prep = render_prep_ms(by_id);
+    const double hilbert_prep = render_prep_ms(hilbert);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Nodes: " << hilbert.num_nodes() << ", arêtes orientées: " << hilbert.num_edges() << std::endl;
+    std::cout << "Construction (Hilbert): " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+    std::cout << "Écart moyen d'indice par arête : ids " << mean_gap(by_id) << " | Hilbert " << mean_gap(hilbert) << std::endl;
+    std::cout << "                      " << std::setw(12) << "ids OSM" << std::setw(12) << "Hilbert" << std::endl;
+    std::cout << "BFS complet (ms)      " << std::setw(12) << id_bfs << std::setw(12) << hilbert_bfs << std::endl;
+    std::cout << "A* x" << std::setw(4) << queries.size() << " (ms)       " << std::setw(12) << id_a_star << std::setw(12) << hilbert_a_star << std::endl;
+    std::cout << "Préparation rendu (ms)" << std::setw(12) << id_prep << std::setw(12) << hilbert_prep
+              << "   (unordered_map : " << map_prep_ms << ")" << std::endl;
+    if (std::abs(id_distance - hilbert_distance) > 0.5 * queries.size()) {
+        std::cout << "Attention : distances A* différentes (" << id_distance << " vs " << hilbert_distance << ")" << std::endl;
+    }
+}
+
+// Nombre d'éléments (nodes, ways, groupes d'objectifs, métadonnées) qui diffèrent entre
+// une GeoBox et sa relecture depuis un cache
+static int count_geobox_differences(const GeoBox& expected, const GeoBox& loaded) {
+    int differences = 0;
+    for (const auto& [node_id, point] : expected.data.nodes) {
+        auto it = loaded.data.nodes.find(node_id);
+        if (it == loaded.data.nodes.end() || it->second.lat != point.lat || it->second.lon != point.lon
+            || !(it->second.groupes == point.groupes) || it->second.incident_ways != point.incident_ways
+            || it->second.objective_id != point.objective_id) {
+            differences++;
+        }
+    }
+    for (const auto& [way_id, way] : expected.data.ways) {
+        auto it = loaded.data.ways.find(way_id);
+        if (it == loaded.data.ways.end() || it->second.node1_id != way.node1_id || it->second.node2_id != way.node2_id
+            || it->second.distance_meters != way.distance_meters || !(it->second.groupes == way.groupes)) {
+            differences++;
+        }
+    }
+    for (const auto& [group_id, group] : expected.data.objective_groups) {
+        auto it = loaded.data.objective_groups.find(group_id);
+        if (it == loaded.data.objective_groups.end() || it->second.name != group.name
+            || it->second.description != group.description || it->second.node_ids != group.node_ids
+            || it->second.point_count != group.point_count) {
+            differences++;
+        }
+    }
+    if (loaded.data.nodes.size() != expected.data.nodes.size() || loaded.data.ways.size() != expected.data.ways.size()
+        || loaded.data.objective_groups.size() != expected.data.objective_groups.size()
+        || loaded.source_file != expected.source_file || loaded.bbox.valid() != expected.bbox.valid()) {
+        differences++;
+    } else if (expected.bbox.valid()
+               && (loaded.bbox.bottom_left().lon() != expected.bbox.bottom_left().lon()
+                   || loaded.bbox.bottom_left().lat() != expected.bbox.bottom_left().lat()
+                   || loaded.bbox.top_right().lon() != expected.bbox.top_right().lon()
+                   || loaded.bbox.top_right().lat() != expected.bbox.top_right().lat())) {
+        differences++;
+    }
+    return differences;
+}
+
+bool verif_cache_roundtrip(const GeoBox& geo_box, const std::string& cache_dir) {
+    std::cout << "\n=== VÉRIFICATION ALLER-RETOUR DES CACHES ===" << std::endl;
+
+    const std::string paths[] = {
+        cache_dir + "//roundtrip_cache.json",
+        cache_dir + "//roundtrip_cache" + GeoBoxManager::CACHE_EXTENSION,
+        cache_dir + "//roundtrip_cache" + GeoBoxManager::COMPACT_EXTENSION
+    };
+
+    bool all_identical = true;
+    for (const std::string& path : paths) {
+        int differences = -1;
+        if (GeoBoxManager::save_geobox(geo_box, path)) {
+            const GeoBox loaded = GeoBoxManager::load_geobox(path);
+            differences = loaded.is_valid ? count_geobox_differences(geo_box, loaded) : -1;
+        }
+
+        std::cout << std::filesystem::path(path).extension().string() << " : ";
+        if (differences < 0) {
+            std::cout << "ÉCHEC (écriture ou relecture impossible)" << std::endl;
+        } else {
+            std::cout << differences << " élément(s) différent(s), "
+                      << std::filesystem::file_size(path) / 1024 << " Ko" << std::endl;
+        }
+        all_identical = all_identical && differences == 0;
+
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    std::cout << (all_identical ? "Caches fidèles" : "Attention : perte d'information dans un cache") << std::endl;
+    return all_identical;
+}
+
+void benchmark_cache_loading(const GeoBox& geo_box, const std::string& cache_dir, int nb_queries, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK CHARGEMENT DU CACHE (JSON vs BINAIRE PROJETÉ vs COMPACT) ===" << std::endl;
+
+    if (geo_box.data.nodes.size() < 2) {
+        std::cout << "GeoBox trop petite pour le benchmark" << std::endl;
+        return;
+    }
+
+    const std::string json_path = cache_dir + "//benchmark_cache.json";
+    const std::string binary_path = cache_dir + "//benchmark_cache" + GeoBoxManager::CACHE_EXTENSION;
+    const std::string compact_path = cache_dir + "//benchmark_cache" + GeoBoxManager::COMPACT_EXTENSION;
+    const std::string overlay_path = cache_dir + "//benchmark_groups" + GeoBoxManager::OVERLAY_EXTENSION;
+    auto elapsed_ms = [](auto t0) {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+    };
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    GeoBoxManager::export_geobox_json(geo_box, json_path);
+    const double json_save_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBoxManager::save_geobox(geo_box, binary_path);
+    const double binary_save_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBoxManager::save_geobox(geo_box, compact_path);
+    const double compact_save_ms = elapsed_ms(t0);
+
+    // Groupes d'objectifs seuls, au-dessus du cache binaire (sauvegarde après pathfinding)
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBoxManager::save_overlay(geo_box, binary_path, overlay_path);
+    const double overlay_save_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBox from_json = GeoBoxManager::load_geobox(json_path);
+    const double json_load_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBox from_dom = GeoBoxManager::load_geobox_json(json_path, false);
+    const double dom_load_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBox from_binary = GeoBoxManager::load_geobox(binary_path);
+    const double binary_load_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBox from_compact = GeoBoxManager::load_geobox(compact_path);
+    const double compact_load_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    GeoBox from_overlay = GeoBoxManager::load_geobox(overlay_path);
+    const double overlay_load_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    MappedGeoBox mapped = GeoBoxManager::map_geobox(binary_path);
+    const double map_ms = elapsed_ms(t0);
+
+    if (!from_json.is_valid || !from_dom.is_valid || !from_binary.is_valid || !from_compact.is_valid || !from_overlay.is_valid || !mapped.is_open()) {
+        std::cout << "Erreur : cache de benchmark illisible" << std::endl;
+        return;
+    }
+
+    // Requêtes A* : sur la projection directement, et sur un RoadGraph construit après chargement JSON
+    std::mt19937 rng(seed);
+    const auto queries = random_queries(sorted_node_ids(geo_box.data), nb_queries, rng);
+
+    SearchWorkspace workspace;
+    size_t expanded = 0;
+    double mapped_total = 0.0;
+    t0 = std::chrono::high_resolution_clock::now();
+    for (const auto& [start, end] : queries) {
+        const double d = a_star_distance(mapped, workspace, start, end, expanded);
+        if (d > 0.0) mapped_total += d;
+    }
+    const double mapped_queries_ms = elapsed_ms(t0);
+
+    t0 = std::chrono::high_resolution_clock::now();
+    const RoadGraph rg = RoadGraph::build(from_json.data);
+    const double graph_build_ms = elapsed_ms(t0);
+    double graph_total = 0.0;
+    t0 = std::chrono::high_resolution_clock::now();
+    for (const auto& [start, end] : queries) {
+        const double d = a_star_distance(rg, workspace, start, end, expanded);
+        if (d > 0.0) graph_total += d;
+    }
+    const double graph_queries_ms = elapsed_ms(t0);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Nodes: " << geo_box.data.nodes.size() << ", ways: " << geo_box.data.ways.size() << std::endl;
+    std::cout << "Taille JSON   : " << std::filesystem::file_size(json_path) / 1024 << " Ko" << std::endl;
+    std::cout << "Taille binaire: " << mapped.file_bytes() / 1024 << " Ko" << std::endl;
+    std::cout << "Taille compact: " << std::filesystem::file_size(compact_path) / 1024 << " Ko" << std::endl;
+    std::cout << "Sauvegarde JSON / binaire / compact : " << json_save_ms << " / " << binary_save_ms
+              << " / " << compact_save_ms << " ms" << std::endl;
+    std::cout << "JSON via DOM nlohmann            : " << dom_load_ms << " ms" << std::endl;
+    std::cout << "load_geobox JSON (SAX) / binaire : " << json_load_ms << " / " << binary_load_ms << " ms" << std::endl;
+    std::cout << "load_geobox compact              : " << compact_load_ms << " ms" << std::endl;
+    std::cout << "Overlay des groupes (" << geo_box.data.objective_groups.size() << ")          : "
+              << std::filesystem::file_size(overlay_path) / 1024.0 << " Ko, sauvegarde " << overlay_save_ms
+              << " ms, base + overlay " << overlay_load_ms << " ms" << std::endl;
+    std::cout << "map_geobox (projection)          : " << map_ms << " ms" << std::endl;
+    std::cout << "JSON + RoadGraph + " << queries.size() << " A*        : " << json_load_ms + graph_build_ms + graph_queries_ms << " ms" << std::endl;
+    std::cout << "Projection + " << queries.size() << " A*              : " << map_ms + mapped_queries_ms << " ms" << std::endl;
+    if (json_load_ms > 0.0 && binary_load_ms > 0.0) {
+        std::cout << "Accélération load_geobox: x" << json_load_ms / binary_load_ms << std::endl;
+    }
+    if (std::abs(mapped_total - graph_total) > 0.5 * queries.size()) {
+        std::cout << "Attention : distances A* différentes (" << mapped_total << " vs " << graph_total << ")" << std::endl;
+    }
+    std::cout << "Éléments différents après aller-retour SAX / binaire / compact: "
+              << count_geobox_differences(geo_box, from_json) << " / " << count_geobox_differences(geo_box, from_binary)
+              << " / " << count_geobox_differences(geo_box, from_compact) << std::endl;
+    std::cout << "Éléments différents base + overlay : " << count_geobox_differences(geo_box, from_overlay) << std::endl;
+
+    mapped = MappedGeoBox();  // Libère la projection avant suppression (Windows)
+    std::error_code error;
+    std::filesystem::remove(json_path, error);
+    std::filesystem::remove(binary_path, error);
+    std::filesystem::remove(compact_path, error);
+    std::filesystem::remove(overlay_path, error);
+}
+
+void benchmark_distance_matrix(GeoBox& geo_box, int nb_poi, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK MATRICE DE DISTANCES (SCALING) ===" << std::endl;
+
+    if (geo_box.data.nodes.size() < 2 || nb_poi < 2) {
+        std::cout << "GeoBox trop petite pour le benchmark" << std::endl;
+        return;
+    }
+
+    // POI reproductibles (seed fixe)
+    std::mt19937 rng(seed);
+    const std::vector<osmium::object_id_type> node_ids = random_pois(geo_box.data, nb_poi, rng);
+
+    Pathfinder PfSystem(geo_box);
+    PfSystem.road_graph();  // Construction du CSR hors mesure
+
+    // 1, 2, 4, ... jusqu'au nombre de cœurs
+    const unsigned max_threads = ThreadPool::resolve_thread_count(0);
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::cout << "POI: " << node_ids.size() << ", cœurs disponibles: " << max_threads << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    DistanceMatrix reference;
+    double reference_ms = 0.0;
+    for (unsigned threads : thread_counts) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        DistanceMatrix matrix = DistanceMatrix::build(PfSystem, node_ids, static_cast<int>(threads));
+        auto t1 = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+        int mismatches = 0;
+        if (threads == 1) {
+            reference = std::move(matrix);
+            reference_ms = ms;
+        } else {
+            for (size_t i = 0; i < node_ids.size(); ++i) {
+                for (size_t j = 0; j < node_ids.size(); ++j) {
+                    if (matrix.distance(i, j) != reference.distance(i, j)) mismatches++;
+                }
+            }
+        }
+
+        std::cout << "Threads: " << std::setw(3) << threads
+                  << " | " << std::setw(10) << ms << " ms"
+                  << " | accélération x" << (ms > 0.0 ? reference_ms / ms : 0.0)
+                  << " | efficacité " << (ms > 0.0 ? 100.0 * reference_ms / (ms * threads) : 0.0) << " %";
+        if (mismatches > 0) {
+            std::cout << " | " << mismatches << " distances différentes !";
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Hash des paires utilisé par les solveurs avant PairHash (splitmix) : simple XOR,
+// conservé ici pour que la référence du benchmark mesure bien l'ancien cache
+struct LegacyXorPairHash {
+    size_t operator()(const std::pair<osmium::object_id_type, osmium::object_id_type>& p) const {
+        return std::hash<osmium::object_id_type>{}(p.first) ^ std::hash<osmium::object_id_type>{}(p.second);
+    }
+};
+
+void benchmark_tour_distance(GeoBox& geo_box, int nb_poi, int nb_evaluations, unsigned int seed) {
+    std::cout << "\n=== BENCHMARK LONGUEUR DE TOUR (CACHE HASH vs MATRICE DENSE) ===" << std::endl;
+
+    if (geo_box.data.nodes.size() < 2 || nb_poi < 2) {
+        std::cout << "GeoBox trop petite pour le benchmark" << std::endl;
+        return;
+    }
+
+    std::mt19937 rng(seed);
+    const std::vector<osmium::object_id_type> node_ids = random_pois(geo_box.data, nb_poi, rng);
+    const size_t n = node_ids.size();
+
+    Pathfinder PfSystem(geo_box);
+    DistanceMatrix matrix = DistanceMatrix::build(PfSystem, node_ids);
+
+    // Ancien cache des solveurs : clé (min, max) hachée (XOR) à chaque accès
+    std::unordered_map<std::pair<osmium::object_id_type, osmium::object_id_type>, double, LegacyXorPairHash> distance_cache;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            distance_cache[std::make_pair(std::min(node_ids[i], node_ids[j]), std::max(node_ids[i], node_ids[j]))] = matrix.distance(i, j);
+        }
+    }
+
+    // Mêmes tours aléatoires dans les deux représentations
+    Tour index_tour(n);
+    std::iota(index_tour.begin(), index_tour.end(), size_t(0));
+    std::vector<Tour> index_tours;
+    std::vector<std::vector<osmium::object_id_type>> id_tours;
+    for (int t = 0; t < 16; ++t) {
+        std::shuffle(index_tour.begin(), index_tour.end(), rng);
+        index_tours.push_back(index_tour);
+        std::vector<osmium::object_id_type> id_tour(n);
+        for (size_t k = 0; k < n; ++k) id_tour[k] = node_ids[index_tour[k]];
+        id_tours.push_back(id_tour);
+    }
+
+    double hash_total = 0.0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int e = 0; e < nb_evaluations; ++e) {
+        const auto& tour = id_tours[e % id_tours.size()];
+        for (size_t i = 0; i < tour.size(); ++i) {
+            size_t next_i = (i + 1) % tour.size();
+            auto key = std::make_pair(std::min(tour[i], tour[next_i]), std::max(tour[i], tour[next_i]));
+            auto it = distance_cache.find(key);
+            hash_total += (it != distance_cache.end()) ? it->second : std::numeric_limits<double>::max();
+        }
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    double hash_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    double dense_total = 0.0;
+    t0 = std::chrono::high_resolution_clock::now();
+    for (int e = 0; e < nb_evaluations; ++e) {
+        dense_total += matrix.tour_length(index_tours[e % index_tours.size()]);
+    }
+    t1 = std::chrono::high_resolution_clock::now();
+    double dense_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "POI: " << n << ", évaluations: " << nb_evaluations << std::endl;
+    std::cout << "Cache unordered_map + XOR      : " << hash_ms << " ms ("
+              << (hash_ms > 0.0 ? nb_evaluations / hash_ms * 1000.0 : 0.0) << " tours/s)" << std::endl;
+    std::cout << "Matrice dense (indices)        : " << dense_ms << " ms ("
+              << (dense_ms > 0.0 ? nb_evaluations / dense_ms * 1000.0 : 0.0) << " tours/s)" << std::endl;
+    if (dense_ms > 0.0) {
+        std::cout << "Accélération: x" << hash_ms / dense_ms << std::endl;
+    }
+    if (hash_total != dense_total) {
+        std::cout << "Attention : totaux différents (" << hash_total << " vs " << dense_total << ")" << std::endl;
+    }
+}
+
+// ============================================================================
+// VÉRIFICATION DES VOISINAGES (ANCIENS PARCOURS vs MOVEEVALUATOR)
+// ============================================================================
+
+// Anciens parcours des voisinages VNS / GRASP : copie du tour et recalcul complet de sa
+// longueur pour chaque mouvement. Seul le seuil d'acceptation (MoveEvaluator::EPSILON)
+// est repris du nouveau moteur, les mouvements à gain nul n'étant plus acceptés.
+static bool legacy_two_opt_scan(const DistanceMatrix& matrix, Tour& tour, double& total_distance,
+                                size_t i_begin, size_t i_end, size_t min_span, size_t j_end,
+                                bool first_improvement) {
+    Tour best_tour = tour;
+    double best_distance = total_distance;
+    bool improved = false;
+
+    for (size_t i = i_begin; i < i_end && !(improved && first_improvement); ++i) {
+        for (size_t j = i + min_span; j < j_end; ++j) {
+            Tour new_tour = tour;
+            std::reverse(new_tour.begin() + i, new_tour.begin() + j + 1);
+
+            double new_distance = matrix.tour_length(new_tour);
+            if (new_distance < best_distance - MoveEvaluator::EPSILON) {
+                best_tour = new_tour;
+                best_distance = new_distance;
+                improved = true;
+                if (first_improvement) break;
+            }
+        }
+    }
+
+    if (improved) {
+        tour = best_tour;
+        total_distance = best_distance;
+    }
+    return improved;
+}
+
+static bool legacy_swap_scan(const DistanceMatrix& matrix, Tour& tour, double& total_distance, bool first_improvement) {
+    Tour best_tour = tour;
+    double best_distance = total_distance;
+    bool improved = false;
+
+    for (size_t i = 0; i < tour.size() && !(improved && first_improvement); ++i) {
+        for (size_t j = i + 1; j < tour.size(); ++j) {
+            Tour new_tour = tour;
+            std::swap(new_tour[i], new_tour[j]);
+
+            double new_distance = matrix.tour_length(new_tour);
+            if (new_distance < best_distance - MoveEvaluator::EPSILON) {
+                best_tour = new_tour;
+                best_distance = new_distance;
+                improved = true;
+                if (first_improvement) break;
+            }
+        }
+    }
+
+    if (improved) {
+        tour = best_tour;
+        total_distance = best_distance;
+    }
+    return improved;
+}
+
+static bool legacy_relocate_scan(const DistanceMatrix& matrix, Tour& tour, double& total_distance, bool first_improvement) {
+    Tour best_tour = tour;
+    double best_distance = total_distance;
+    bool improved = false;
+
+    for (size_t i = 0; i < tour.size() && !(improved && first_improvement); ++i) {
+        for (size_t j = 0; j < tour.size(); ++j) {
+            if (i == j) continue;
+
+            Tour new_tour = tour;
+            size_t element = new_tour[i];
+            new_tour.erase(new_tour.begin() + i);
+            new_tour.insert(new_tour.begin() + (j > i ? j - 1 : j), element);
+
+            double new_distance = matrix.tour_length(new_tour);
+            if (new_distance < best_distance - MoveEvaluator::EPSILON) {
+                best_tour = new_tour;
+                best_distance = new_distance;
+                improved = true;
+                if (first_improvement) break;
+            }
+        }
+    }
+
+    if (improved) {
+        tour = best_tour;
+        total_distance = best_distance;
+    }
+    return improved;
+}
+
+bool verif_move_evaluator(GeoBox& geo_box, int nb_poi, int nb_tours, unsigned int seed) {
+    std::cout << "\n=== VÉRIFICATION DES VOISINAGES (ANCIEN PARCOURS vs MOVEEVALUATOR) ===" << std::endl;
+
+    if (geo_box.data.nodes.size() < 2 || nb_poi < 2 || nb_tours < 1) {
+        std::cout << "GeoBox trop petite pour la vérification" << std::endl;
+        return false;
+    }
+
+    std::mt19937 rng(seed);
+    const std::vector<osmium::object_id_type> node_ids = random_pois(geo_box.data, nb_poi, rng);
+
+    Pathfinder PfSystem(geo_box);
+    DistanceMatrix matrix = DistanceMatrix::build(PfSystem, node_ids);
+
+    // POI mutuellement atteignables : ceux reliés dans les deux sens au POI le mieux connecté
+    // (une distance UNREACHABLE rendrait les longueurs de tour infinies)
+    const size_t n = matrix.size();
+    auto reachable = [&](size_t i, size_t j) {
+        return matrix.distance(i, j) != DistanceMatrix::UNREACHABLE && matrix.distance(j, i) != DistanceMatrix::UNREACHABLE;
+    };
+    size_t anchor = 0, anchor_degree = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t degree = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (reachable(i, j)) degree++;
+        }
+        if (degree > anchor_degree) {
+            anchor = i;
+            anchor_degree = degree;
+        }
+    }
+    Tour pois;
+    for (size_t j = 0; j < n; ++j) {
+        if (reachable(anchor, j)) pois.push_back(j);
+    }
+    if (pois.size() < 5) {
+        std::cout << "Pas assez de POI mutuellement atteignables (" << pois.size() << ")" << std::endl;
+        return false;
+    }
+
+    // Voisinages comparés : mêmes bornes que dans VNSSolver et GRASPSolver
+    struct Neighborhood {
+        const char* name;
+        std::function<bool(Tour&, double&, bool)> legacy;
+        std::function<bool(Tour&, double&, bool)> evaluated;
+    };
+    const MoveEvaluator evaluator(matrix);
+    const size_t m = pois.size();
+    const Neighborhood neighborhoods[] = {
+        {"VNS 2-opt",
+         [&](Tour& t, double& d, bool f) { return legacy_two_opt_scan(matrix, t, d, 1, m - 1, 1, m, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_two_opt(t, d, 1, m - 1, 1, m, f); }},
+        {"VNS 3-opt",
+         [&](Tour& t, double& d, bool f) { return legacy_two_opt_scan(matrix, t, d, 0, m - 2, 2, m, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_two_opt(t, d, 0, m - 2, 2, m, f); }},
+        {"GRASP 2-opt",
+         [&](Tour& t, double& d, bool f) { return legacy_two_opt_scan(matrix, t, d, 1, m - 2, 1, m, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_two_opt(t, d, 1, m - 2, 1, m, f); }},
+        {"GRASP 3-opt",
+         [&](Tour& t, double& d, bool f) { return legacy_two_opt_scan(matrix, t, d, 1, m - 2, 1, m - 2, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_two_opt(t, d, 1, m - 2, 1, m - 2, f); }},
+        {"Relocate",
+         [&](Tour& t, double& d, bool f) { return legacy_relocate_scan(matrix, t, d, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_relocate(t, d, f); }},
+        {"Swap",
+         [&](Tour& t, double& d, bool f) { return legacy_swap_scan(matrix, t, d, f); },
+         [&](Tour& t, double& d, bool f) { return evaluator.best_swap(t, d, f); }},
+    };
+
+    // Tours de départ reproductibles (seed fixe), communs à tous les voisinages
+    std::vector<Tour> start_tours;
+    Tour tour = pois;
+    for (int t = 0; t < nb_tours; ++t) {
+        std::shuffle(tour.begin(), tour.end(), rng);
+        start_tours.push_back(tour);
+    }
+
+    std::cout << "POI: " << m << ", tours de départ: " << start_tours.size() << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    bool all_identical = true;
+    for (const Neighborhood& neighborhood : neighborhoods) {
+        for (bool first_improvement : {false, true}) {
+            int differences = 0;
+            size_t moves = 0;
+            double legacy_ms = 0.0, evaluated_ms = 0.0;
+
+            for (const Tour& start : start_tours) {
+                Tour legacy_tour = start, evaluated_tour = start;
+                double legacy_distance = matrix.tour_length(start), evaluated_distance = legacy_distance;
+
+                // Descente jusqu'à l'optimum local, tours comparés après chaque mouvement
+                for (size_t step = 0; step < 10 * m * m; ++step) {
+                    auto t0 = std::chrono::high_resolution_clock::now();
+                    const bool legacy_improved = neighborhood.legacy(legacy_tour, legacy_distance, first_improvement);
+                    auto t1 = std::chrono::high_resolution_clock::now();
+                    const bool evaluated_improved = neighborhood.evaluated(evaluated_tour, evaluated_distance, first_improvement);
+                    auto t2 = std::chrono::high_resolution_clock::now();
+                    legacy_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+                    evaluated_ms += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+                    if (legacy_improved != evaluated_improved || legacy_tour != evaluated_tour) {
+                        differences++;
+                        break;
+                    }
+                    if (!legacy_improved) break;
+                    moves++;
+                }
+            }
+
+            std::cout << std::left << std::setw(12) << neighborhood.name << std::right
+                      << (first_improvement ? " (premier) " : " (meilleur)")
+                      << " | " << std::setw(6) << moves << " mouvements"
+                      << " | ancien " << std::setw(9) << legacy_ms << " ms"
+                      << " | delta " << std::setw(8) << evaluated_ms << " ms"
+                      << " | " << differences << " tour(s) différent(s)" << std::endl;
+            all_identical = all_identical && differences == 0;
+        }
+    }
+
+    std::cout << (all_identical ? "Voisinages identiques" : "Attention : l'évaluation delta change les tours acceptés") << std::endl;
+    return all_identical;
+}
+
+// ============================================================================
+// BENCHMARK MÉMOIRE DE L'INGESTION (ANCIENNE vs NOUVELLE DISPOSITION DES POSITIONS)
+// ============================================================================
+
+// Mémoire résidente du processus en octets (0 si indisponible)
+static size_t current_rss_bytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#else
+    // /proc/self/statm : taille totale puis pages résidentes
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Ancienne disposition reproduite autour du handler actuel : position de chaque node du
+// fichier dans une unordered_map et MyData::Point pour chaque node de la bbox (y compris
+// ceux des bâtiments, supprimés à la fin comme orphelins). Les ways sont traités par
+// MyHandler, dont l'index compact des positions s'ajoute ici (16 octets par node de la bbox).
+class LegacyLocationHandler : public osmium::handler::Handler {
+public:
+    explicit LegacyLocationHandler(MyHandler& handler) : handler(handler) {}
+
+    void node(const osmium::Node& node) {
+        const osmium::Location location = node.location();
+        if (!location.valid()) return;
+
+        node_locations[node.id()] = location;
+        if (!handler.Map_bbox.contains(location)) return;
+
+        handler.data_collector.nodes[node.id()] = MyData::Point(location.lat(), location.lon(), node.id());
+        handler.node(node);
+    }
+
+    void way(const osmium::Way& way) { handler.way(way); }
+
+    size_t location_count() const { return node_locations.size(); }
+
+private:
+    MyHandler& handler;
+    std::unordered_map<osmium::object_id_type, osmium::Location> node_locations;
+};
+
+void benchmark_ingest_memory(const GeoBox& geo_box) {
+    std::cout << "\n=== BENCHMARK MÉMOIRE DE L'INGESTION (POSITIONS DU FICHIER vs DE LA BBOX) ===" << std::endl;
+
+    std::error_code error;
+    if (!geo_box.bbox.valid() || geo_box.source_file.empty() || !std::filesystem::exists(geo_box.source_file, error)) {
+        std::cout << "Fichier OSM source introuvable: " << geo_box.source_file << std::endl;
+        return;
+    }
+    if (current_rss_bytes() == 0) {
+        std::cout << "Mémoire résidente non mesurable sur cette plateforme" << std::endl;
+        return;
+    }
+
+    // Lecture séquentielle complète (sans index de blocs) : RSS en fin de lecture, avant
+    // libération des positions, relativement au RSS avant lecture.
+    // La nouvelle disposition est mesurée en premier : l'ancienne peut réutiliser la mémoire
+    // libérée sans que le RSS augmente, son coût n'est donc pas surestimé.
+    struct Measure { double rss_mb; double ms; size_t nodes; size_t ways; };
+    auto measure = [&](bool legacy) {
+        MyHandler handler;
+        handler.Map_bbox = geo_box.bbox;
+        handler.enable_bounding_box_filter(true);
+
+        const size_t rss_before = current_rss_bytes();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        osmium::io::Reader reader(geo_box.source_file, osmium::io::read_meta::no);
+        size_t rss_after = 0;
+        if (legacy) {
+            LegacyLocationHandler legacy_handler(handler);
+            osmium::apply(reader, legacy_handler);
+            rss_after = current_rss_bytes();
+            std::cout << "Positions conservées par l'ancienne disposition: " << legacy_handler.location_count() << std::endl;
+        } else {
+            osmium::apply(reader, handler);
+            rss_after = current_rss_bytes();
+        }
+        reader.close();
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        return Measure{
+            (static_cast<double>(rss_after) - static_cast<double>(rss_before)) / (1024.0 * 1024.0),
+            std::chrono::duration<double, std::milli>(t1 - t0).count(),
+            handler.data_collector.nodes.size(),
+            handler.data_collector.ways.size()
+        };
+    };
+
+    const Measure current = measure(false);
+    const Measure legacy = measure(true);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Fichier: " << geo_box.source_file << " ("
+              << std::filesystem::file_size(geo_box.source_file, error) / (1024 * 1024) << " Mo)" << std::endl;
+    std::cout << "Positions du fichier + Points bbox (ancien) : +" << legacy.rss_mb << " Mo RSS, "
+              << legacy.ms << " ms, " << legacy.nodes << " nodes (orphelins inclus), " << legacy.ways << " ways" << std::endl;
+    std::cout << "Positions de la bbox seules (actuel)        : +" << current.rss_mb << " Mo RSS, "
+              << current.ms << " ms, " << current.nodes << " nodes, " << current.ways << " ways" << std::endl;
+    if (current.rss_mb > 0.0) {
+        std::cout << "Réduction: x" << legacy.rss_mb / current.rss_mb << std::endl;
+    }
+}
@@ -22,6 +22,8 @@ void with_flickr_objectives(const std::string& osm_file,
                            const std::string& output_name = "flickr_map",
                            int width = 2000, int height = 2000);
 
+// Crée (ou reprend du cache si les entrées sont identiques, cf. GeoBoxCache), sauvegarde
+// sous <cache_prefix>.gbx et rend une GeoBox
 void complete_workflow(const std::string& osm_file,
                       double min_lon, double min_lat, double max_lon, double max_lat,
                       const std::string& cache_dir,
@@ -31,10 +33,50 @@ void complete_workflow(const std::string& osm_file,
                       const FlickrConfig& flickr_config,
                       bool use_flickr_objectives = true);
 
+// Crée et sauvegarde plusieurs GeoBox (nom, bbox) en une seule lecture du fichier OSM ;
+// les régions déjà en cache avec les mêmes entrées ne sont pas relues
+void create_save_batch(const std::string& osm_file,
+                       const std::vector<std::pair<std::string, osmium::Box>>& regions,
+                       const std::string& cache_dir);
+
 void validate_data_integrity(const GeoBox& geo_box);
 
+// Sauvegarde puis relit la GeoBox dans chaque format de cache (JSON, binaire, compact) et
+// compare le contenu ; vrai si les trois relectures sont identiques à l'original
+bool verif_cache_roundtrip(const GeoBox& geo_box, const std::string& cache_dir);
+
 bool verif_pathfinding(Pathfinder& PfSystem,
     const std::vector<osmium::object_id_type>& objective_nodes,
     int path_group);
 
+// Benchmark : A* binaire + heuristique vs ancienne implémentation (liste linéaire, h = 0)
+void benchmark_pathfinding(GeoBox& geo_box, int nb_queries = 50, unsigned int seed = 42);
+
+// Benchmark : A* sur l'instantané complet vs contracté (chaînes de degré 2)
+void benchmark_chain_contraction(GeoBox& geo_box, int nb_queries = 50, unsigned int seed = 42);
+
+// Benchmark : parcours sur unordered_map (MyData) vs instantané CSR (RoadGraph)
+void benchmark_road_graph(const GeoBox& geo_box, int repetitions = 5);
+
+// Benchmark : numérotation des nodes par ids OSM vs courbe de Hilbert (BFS, A*, préparation du rendu)
+void benchmark_node_ordering(const GeoBox& geo_box, int nb_queries = 200, int repetitions = 5, unsigned int seed = 42);
+
+// Benchmark : cache JSON vs binaire vs compact vs overlay de groupes (taille, chargement, projection mémoire + requêtes A*)
+void benchmark_cache_loading(const GeoBox& geo_box, const std::string& cache_dir, int nb_queries = 200, unsigned int seed = 42);
+
+// Benchmark : passage à l'échelle de la matrice de distances selon le nombre de threads
+void benchmark_distance_matrix(GeoBox& geo_box, int nb_poi = 200, unsigned int seed = 42);
+
+// Benchmark : calculate_tour_distance via cache unordered_map (PairHash) vs matrice dense indexée
+void benchmark_tour_distance(GeoBox& geo_box, int nb_poi = 200, int nb_evaluations = 20000, unsigned int seed = 42);
+
+// Descentes VNS / GRASP (2-opt, 3-opt simplifié, relocate, swap) depuis les mêmes tours
+// aléatoires : anciens parcours (recalcul complet) vs MoveEvaluator ; vrai si les tours
+// acceptés sont identiques à chaque mouvement
+bool verif_move_evaluator(GeoBox& geo_box, int nb_poi = 30, int nb_tours = 5, unsigned int seed = 42);
+
+// Benchmark : RSS de la lecture du fichier OSM source de la GeoBox, positions de tous les
+// nodes du fichier (ancienne ingestion) vs positions des seuls nodes de la bbox
+void benchmark_ingest_memory(const GeoBox& geo_box);
+
 #endif // UTILITY_HPP
\ No newline at end of file